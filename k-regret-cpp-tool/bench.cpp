@@ -0,0 +1,462 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+// Benchmark driver: times the load, selection and evaluation phases over
+// synthetic and real datasets and writes the results as CSV or JSON
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <kregret/cube.h>
+#include <kregret/data_reader.h>
+#include <kregret/dataset.h>
+#include <kregret/generator.h>
+#include <kregret/greedy.h>
+#include <kregret/hitting_set.h>
+#include <kregret/parallel.h>
+#include <kregret/planar.h>
+#include <kregret/regret.h>
+#include <kregret/size_list.h>
+#include <kregret/sphere.h>
+
+#ifndef KREGRET_TEST_DATA_DIR
+#define KREGRET_TEST_DATA_DIR "test_data"
+#endif
+
+void printHelp(const char* programName) {
+    std::string name = std::filesystem::path(programName).filename().string();
+    std::cout << "\nNAME\n";
+    std::cout << "    " << name << " - Time the k-regret phases over synthetic and real workloads\n\n";
+
+    std::cout << "SYNOPSIS\n";
+    std::cout << "    " << name << " [-g DISTRIBUTIONS] [-n SIZES] [-d SIZES] [-k SIZES] [-j SIZES] [-a ALGORITHMS]\n";
+    std::cout << "        [-e EVALUATORS] [-f FILE ...] [-r REPS] [--seed S] [--samples M] [--keep DIR]\n";
+    std::cout << "        [--json] [-o OUTPUT] [-h]\n\n";
+
+    std::cout << "DESCRIPTION\n";
+    std::cout << "    Every dataset is loaded through the CSV reader, once per thread count, and every\n";
+    std::cout << "    algorithm is run for every k and scored by every evaluator. Each phase is repeated\n";
+    std::cout << "    REPS times and its median time is reported, so that results can be compared\n";
+    std::cout << "    between builds. Progress goes to stderr, results to stdout or OUTPUT.\n\n";
+
+    std::cout << "OPTIONS\n";
+    std::cout << "    SIZES is a size, a range FIRST:LAST[:STEP] or a comma-separated list of either;\n";
+    std::cout << "    the other lists are comma-separated names.\n\n";
+    std::cout << "    -g DISTRIBUTIONS\n";
+    std::cout << "        Synthetic data in [0,1]^d: independent, correlated, anticorrelated, or none\n";
+    std::cout << "        (default: all three).\n\n";
+    std::cout << "    -n SIZES\n";
+    std::cout << "        Points per synthetic dataset (default: 10000,100000).\n\n";
+    std::cout << "    -d SIZES\n";
+    std::cout << "        Dimensions of the synthetic datasets (default: 3,6).\n\n";
+    std::cout << "    -k SIZES\n";
+    std::cout << "        Result set sizes (default: 10,50).\n\n";
+    std::cout << "    -j SIZES\n";
+    std::cout << "        Thread counts (default: 1 and the number of hardware threads).\n\n";
+    std::cout << "    -a ALGORITHMS\n";
+    std::cout << "        Any of cube, greedy, sphere, hs (default: cube,greedy).\n\n";
+    std::cout << "    -e EVALUATORS\n";
+    std::cout << "        Any of axis, exact, sampled (default: axis).\n\n";
+    std::cout << "    -f FILE\n";
+    std::cout << "        A real dataset, with the separator taken from its first line; may be repeated.\n";
+    std::cout << "        \"-f none\" skips them. Default: nba.dat and stock.dat from test_data.\n\n";
+    std::cout << "    -r REPS\n";
+    std::cout << "        Repetitions of each phase (default: 3).\n\n";
+    std::cout << "    --seed S\n";
+    std::cout << "        Seed of the generators, the sampled evaluator and hs (default: 1).\n\n";
+    std::cout << "    --samples M\n";
+    std::cout << "        Utilities drawn by the sampled evaluator (default: 100000).\n\n";
+    std::cout << "    --keep DIR\n";
+    std::cout << "        Write the generated datasets to DIR and keep them (default: a temporary\n";
+    std::cout << "        file that is removed afterwards).\n\n";
+    std::cout << "    --json\n";
+    std::cout << "        Write JSON instead of CSV.\n\n";
+    std::cout << "    -o OUTPUT\n";
+    std::cout << "        Write the results to OUTPUT instead of stdout.\n\n";
+
+    std::cout << "OUTPUT\n";
+    std::cout << "    One record per dataset, thread count, algorithm, evaluator and k: dataset,\n";
+    std::cout << "    distribution (\"file\" for real data), n, d, threads, algorithm, evaluator, k, reps,\n";
+    std::cout << "    load_ms, select_ms, eval_ms and max_regret.\n\n";
+    std::cout << std::flush;
+}
+
+struct bench_settings {
+    std::vector<distribution> distributions = { distribution::independent, distribution::correlated,
+                                                distribution::anticorrelated };
+    std::vector<size_t> sizes = { 10000, 100000 };
+    std::vector<size_t> dimensions = { 3, 6 };
+    std::vector<size_t> ks = { 10, 50 };
+    std::vector<size_t> threads;
+    std::vector<std::string> algorithms = { "cube", "greedy" };
+    std::vector<std::string> evaluators = { "axis" };
+    std::vector<std::string> files;
+    size_t reps = 3;
+    uint64_t seed = 1;
+    size_t samples = 100000;
+    std::string keep;
+    bool json = false;
+};
+
+// A dataset to measure: a real file, or a generated one written to path
+struct bench_source {
+    std::string name;
+    std::string origin; // the distribution, or "file"
+    std::string path;
+    char sep;
+    bool generated;
+    distribution kind;
+    size_t n, d;
+    bool temporary;
+};
+
+struct bench_record {
+    std::string dataset;
+    std::string distribution;
+    size_t n, d, threads;
+    std::string algorithm, evaluator;
+    size_t k;
+    double loadMs, selectMs, evalMs, regret;
+};
+
+std::vector<std::string> splitList(const std::string& arg) {
+    std::vector<std::string> items;
+    std::stringstream stream(arg);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+// The first of , | ; and tab on the first line, otherwise a space
+char detectSeparator(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    for (char sep : { ',', '|', ';', '\t' }) {
+        if (line.find(sep) != std::string::npos) return sep;
+    }
+    return ' ';
+}
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    size_t m = values.size() / 2;
+    return values.size() % 2 ? values[m] : (values[m - 1] + values[m]) / 2;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void select(const std::string& algorithm, const dataset& ds, size_t K, const bench_settings& settings, int* indices) {
+    if (algorithm == "greedy") {
+        greedy(ds, (int)K, indices);
+    }
+    else if (algorithm == "sphere") {
+        sphere(ds, (int)K, indices);
+    }
+    else if (algorithm == "hs") {
+        hittingSet(ds, (int)K, indices, 0, settings.seed);
+    }
+    else if (planarApplies(ds)) {
+        planar(ds, (int)K, indices);
+    }
+    else {
+        cube(ds, (int)K, indices);
+    }
+}
+
+// Scored from scratch, as a single run of k-regret-tool would
+double evaluate(const std::string& evaluator, const dataset& ds, const std::vector<int>& indices,
+                const bench_settings& settings) {
+    std::vector<size_t> rows(indices.begin(), indices.end());
+    if (evaluator == "exact") {
+        return exactMaxRegretRatio(ds, selectRows(ds, rows));
+    }
+    if (evaluator == "sampled") {
+        return sampledMaxRegretRatio(ds, selectRows(ds, rows), settings.samples, settings.seed).maxRegret;
+    }
+    std::vector<size_t> argmax(ds.d);
+    columnArgMax(ds, argmax.data());
+    return axisMaxRegretRatio(ds, argmax.data(), rows);
+}
+
+// Runs every thread count, algorithm, evaluator and k over one source.
+// Returns false if the source cannot be read.
+bool measure(const bench_source& source, const bench_settings& settings, std::vector<bench_record>& records) {
+    for (size_t threads : settings.threads) {
+        setWorkerCount(threads);
+
+        dataset ds;
+        std::vector<double> load;
+        for (size_t r = 0; r < settings.reps; r++) {
+            auto start = std::chrono::steady_clock::now();
+            if (readDataset(source.path.c_str(), source.sep, ds) != read_status::ok) {
+                std::cerr << "Error: Cannot read " << source.path << std::endl;
+                return false;
+            }
+            load.push_back(elapsedMs(start));
+        }
+
+        for (const std::string& algorithm : settings.algorithms) {
+            for (size_t K : settings.ks) {
+                if (K > ds.n) {
+                    std::cerr << "Skipping k=" << K << " on " << source.name << ": only " << ds.n << " points" << std::endl;
+                    continue;
+                }
+                std::cerr << source.name << ": " << algorithm << " k=" << K << " threads=" << threads << std::endl;
+
+                std::vector<int> indices(K);
+                std::vector<double> selectTimes;
+                for (size_t r = 0; r < settings.reps; r++) {
+                    auto start = std::chrono::steady_clock::now();
+                    select(algorithm, ds, K, settings, indices.data());
+                    selectTimes.push_back(elapsedMs(start));
+                }
+
+                for (const std::string& evaluator : settings.evaluators) {
+                    std::vector<double> evalTimes;
+                    double regret = 0.0;
+                    for (size_t r = 0; r < settings.reps; r++) {
+                        auto start = std::chrono::steady_clock::now();
+                        regret = evaluate(evaluator, ds, indices, settings);
+                        evalTimes.push_back(elapsedMs(start));
+                    }
+                    records.push_back({ source.name, source.origin, ds.n, ds.d, threads, algorithm, evaluator, K,
+                                        median(load), median(selectTimes), median(evalTimes), regret });
+                }
+            }
+        }
+    }
+    setWorkerCount(0);
+    return true;
+}
+
+std::string jsonString(const std::string& text) {
+    std::string quoted = "\"";
+    for (char ch : text) {
+        if (ch == '"' || ch == '\\') quoted += '\\';
+        if ((unsigned char)ch < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char)ch);
+            quoted += escaped;
+            continue;
+        }
+        quoted += ch;
+    }
+    return quoted + "\"";
+}
+
+void writeRecords(std::ostream& out, const std::vector<bench_record>& records, const bench_settings& settings) {
+    out << std::fixed;
+    if (!settings.json) {
+        out << "dataset,distribution,n,d,threads,algorithm,evaluator,k,reps,load_ms,select_ms,eval_ms,max_regret\n";
+        for (const bench_record& r : records) {
+            out << r.dataset << "," << r.distribution << "," << r.n << "," << r.d << "," << r.threads << ","
+                << r.algorithm << "," << r.evaluator << "," << r.k << "," << settings.reps << ","
+                << std::setprecision(3) << r.loadMs << "," << r.selectMs << "," << r.evalMs << ","
+                << std::setprecision(6) << r.regret << "\n";
+        }
+        return;
+    }
+
+    out << "{\n  \"seed\": " << settings.seed << ",\n  \"reps\": " << settings.reps << ",\n  \"results\": [";
+    for (size_t i = 0; i < records.size(); i++) {
+        const bench_record& r = records[i];
+        out << (i ? ",\n" : "\n") << "    {\"dataset\": " << jsonString(r.dataset)
+            << ", \"distribution\": " << jsonString(r.distribution) << ", \"n\": " << r.n << ", \"d\": " << r.d
+            << ", \"threads\": " << r.threads << ", \"algorithm\": " << jsonString(r.algorithm)
+            << ", \"evaluator\": " << jsonString(r.evaluator) << ", \"k\": " << r.k
+            << std::setprecision(3) << ", \"load_ms\": " << r.loadMs << ", \"select_ms\": " << r.selectMs
+            << ", \"eval_ms\": " << r.evalMs << std::setprecision(6) << ", \"max_regret\": " << r.regret << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+bool parseSizeOption(const char* option, const char* arg, std::vector<size_t>& sizes) {
+    std::string error;
+    if (!parseSizes(arg, sizes, error)) {
+        std::cerr << "Error: Invalid " << option << " value (" << error << ")\n";
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    bench_settings settings;
+    std::string output;
+    bool filesGiven = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-h" || arg == "--help") {
+            printHelp(argv[0]);
+            return 0;
+        }
+        else if (arg == "--json") {
+            settings.json = true;
+        }
+        else if (!hasValue) {
+            std::cerr << "Error: Unknown option or missing value: " << arg << "\n";
+            return 1;
+        }
+        else if (arg == "-g") {
+            settings.distributions.clear();
+            for (const std::string& name : splitList(argv[++i])) {
+                distribution kind;
+                if (name == "none") continue;
+                if (!parseDistribution(name, kind)) {
+                    std::cerr << "Error: Unknown distribution '" << name << "'\n";
+                    return 1;
+                }
+                settings.distributions.push_back(kind);
+            }
+        }
+        else if (arg == "-n" || arg == "-d" || arg == "-k" || arg == "-j") {
+            std::vector<size_t>& sizes = arg == "-n" ? settings.sizes : arg == "-d" ? settings.dimensions
+                                       : arg == "-k" ? settings.ks : settings.threads;
+            if (!parseSizeOption(arg.c_str(), argv[++i], sizes)) return 1;
+        }
+        else if (arg == "-a" || arg == "-e") {
+            bool engines = arg == "-a";
+            std::vector<std::string> names = splitList(argv[++i]);
+            for (const std::string& name : names) {
+                bool known = engines ? (name == "cube" || name == "greedy" || name == "sphere" || name == "hs")
+                                     : (name == "axis" || name == "exact" || name == "sampled");
+                if (!known) {
+                    std::cerr << "Error: Unknown " << (engines ? "algorithm" : "evaluator") << " '" << name << "'\n";
+                    return 1;
+                }
+            }
+            (engines ? settings.algorithms : settings.evaluators) = names;
+        }
+        else if (arg == "-f") {
+            filesGiven = true;
+            if (strcmp(argv[++i], "none") != 0) settings.files.push_back(argv[i]);
+        }
+        else if (arg == "-r" || arg == "--seed" || arg == "--samples") {
+            std::string value = argv[++i];
+            unsigned long long number;
+            try {
+                size_t used = 0;
+                number = std::stoull(value, &used);
+                if (used != value.size() || value[0] == '-') throw std::invalid_argument(value);
+            } catch (const std::exception&) {
+                std::cerr << "Error: " << arg << " requires a non-negative integer\n";
+                return 1;
+            }
+            if (arg != "--seed" && number == 0) {
+                std::cerr << "Error: " << arg << " must be positive\n";
+                return 1;
+            }
+            if (arg == "-r") settings.reps = (size_t)number;
+            else if (arg == "--seed") settings.seed = number;
+            else settings.samples = (size_t)number;
+        }
+        else if (arg == "--keep") {
+            settings.keep = argv[++i];
+        }
+        else if (arg == "-o") {
+            output = argv[++i];
+        }
+        else {
+            std::cerr << "Error: Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    if (settings.threads.empty()) {
+        settings.threads = { 1, workerCount() };
+        settings.threads.erase(std::unique(settings.threads.begin(), settings.threads.end()), settings.threads.end());
+    }
+    if (!filesGiven) {
+        for (const char* name : { "nba.dat", "stock.dat" }) {
+            std::filesystem::path path = std::filesystem::path(KREGRET_TEST_DATA_DIR) / name;
+            if (std::filesystem::exists(path)) settings.files.push_back(path.string());
+        }
+    }
+
+    std::vector<bench_source> sources;
+    for (const std::string& file : settings.files) {
+        sources.push_back({ std::filesystem::path(file).filename().string(), "file", file, detectSeparator(file),
+                            false, distribution::independent, 0, 0, false });
+    }
+
+    std::filesystem::path directory = settings.keep.empty() ? std::filesystem::temp_directory_path()
+                                                            : std::filesystem::path(settings.keep);
+    std::string tag = settings.keep.empty() ? "-" + std::to_string(std::random_device()()) : "";
+    for (distribution kind : settings.distributions) {
+        for (size_t N : settings.sizes) {
+            for (size_t D : settings.dimensions) {
+                std::string name = std::string(distributionName(kind)) + "-" + std::to_string(N) + "x" + std::to_string(D);
+                std::string path = (directory / (name + "-s" + std::to_string(settings.seed) + tag + ".csv")).string();
+                sources.push_back({ name, distributionName(kind), path, ',', true, kind, N, D, settings.keep.empty() });
+            }
+        }
+    }
+
+    std::ofstream file;
+    if (!output.empty()) {
+        file.open(output, std::ios::trunc);
+        if (!file) {
+            std::cerr << "Error: Cannot write " << output << std::endl;
+            return 2;
+        }
+    }
+
+    std::vector<bench_record> records;
+    int status = 0;
+    for (const bench_source& source : sources) {
+        if (source.generated) {
+            // generated and written outside the timed phases; the load phase reads it back
+            auto start = std::chrono::steady_clock::now();
+            dataset ds = generateDataset(source.kind, source.d, source.n, settings.seed);
+            if (!writeDatasetText(source.path.c_str(), ds, source.sep)) {
+                std::cerr << "Error: Cannot write " << source.path << std::endl;
+                return 2;
+            }
+            std::cerr << "Generated " << source.name << " in " << std::fixed << std::setprecision(1)
+                      << elapsedMs(start) << " ms" << std::endl;
+        }
+
+        if (!measure(source, settings, records)) {
+            status = 2;
+        }
+        if (source.temporary) {
+            std::error_code ignored;
+            std::filesystem::remove(source.path, ignored);
+        }
+    }
+
+    writeRecords(output.empty() ? std::cout : file, records, settings);
+    return status;
+}
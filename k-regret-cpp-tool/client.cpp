@@ -0,0 +1,121 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+// Minimal client for the --serve socket: sends request lines, prints replies
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static bool sendLine(int fd, const std::string& line) {
+    std::string data = line + "\n";
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += (size_t)n;
+    }
+    return true;
+}
+
+// Reads up to and excluding the next newline; false once the server has closed
+static bool readLine(int fd, std::string& pending, std::string& line) {
+    char buffer[4096];
+    size_t eol;
+    while ((eol = pending.find('\n')) == std::string::npos) {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        pending.append(buffer, (size_t)n);
+    }
+    line = pending.substr(0, eol);
+    pending.erase(0, eol + 1);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || strcmp(argv[1], "-h") == 0) {
+        std::cerr << "Usage: " << argv[0] << " SOCKET [REQUEST ...]\n"
+                  << "Sends each REQUEST (or, without any, each line of stdin) to a k-regret-tool\n"
+                  << "started with --serve SOCKET and prints the replies.\n";
+        return argc < 2 ? 1 : 0;
+    }
+
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(argv[1]) >= sizeof(address.sun_path)) {
+        std::cerr << "Error: Socket path is too long\n";
+        return 1;
+    }
+    strcpy(address.sun_path, argv[1]);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+        std::cerr << "Error: Cannot connect to " << argv[1] << ": " << strerror(errno) << std::endl;
+        return 2;
+    }
+
+    std::vector<std::string> requests(argv + 2, argv + argc);
+    bool fromStdin = requests.empty();
+    std::string request, reply, pending;
+    size_t next = 0;
+    int status = 0;
+
+    for (;;) {
+        if (fromStdin ? !std::getline(std::cin, request) : next == requests.size()) break;
+        if (!fromStdin) request = requests[next++];
+        if (request.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+        if (!sendLine(fd, request)) {
+            std::cerr << "Error: Connection closed by server\n";
+            status = 2;
+            break;
+        }
+        // quit gets no reply
+        if (request.compare(request.find_first_not_of(" \t"), 4, "quit") == 0) break;
+        if (!readLine(fd, pending, reply)) {
+            std::cerr << "Error: Connection closed by server\n";
+            status = 2;
+            break;
+        }
+        std::cout << reply << std::endl;
+        if (reply.compare(0, 5, "error") == 0) status = 3;
+    }
+
+    close(fd);
+    return status;
+}
+
+#else
+
+int main(int, char* argv[]) {
+    std::cerr << argv[0] << ": Unix domain sockets are not supported on this platform\n";
+    return 1;
+}
+
+#endif
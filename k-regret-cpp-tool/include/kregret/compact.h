@@ -0,0 +1,174 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#ifndef KREGRET_INCLUDE_COMPACT_H_
+#define KREGRET_INCLUDE_COMPACT_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <kregret/dataset.h>
+
+// Storage of the working copy scanned by the cube algorithm
+enum class precision
+{
+	full,       // the doubles themselves
+	float32,    // 4 bytes per value
+	quantized16 // 2 bytes per value, evenly spaced between the column extremes
+};
+
+// Accepts double, float32 and q16
+bool parsePrecision(const std::string& name, precision& out);
+const char* precisionName(precision p);
+
+// Column-major view of the reduced values: value j of point i decodes to
+// offset[j] + step[j] * data[j * n + i]
+template <class T>
+struct compact_view
+{
+	const T* data;
+	size_t n;
+	const double* offset;
+	const double* step;
+	const double* bound;   // largest encoding error in each column
+	const double* lowest;  // column extremes of the doubles
+	const double* highest;
+	const long* zero;      // the code that only 0 maps to, or -1
+
+	double value(size_t i, size_t j) const { return offset[j] + step[j] * (double)data[j * n + i]; }
+
+	// Interval [lo, hi] that holds the double behind value(i, j)
+	void range(size_t i, size_t j, double& lo, double& hi) const
+	{
+		T code = data[j * n + i];
+		double a = value(i, j), e = bound[j];
+		if constexpr (std::is_same<T, float>::value)
+		{
+			// a float is within 2^-24 of its own magnitude, however large the
+			// column, and has the sign of the double it came from
+			e = std::min(e, std::fabs(a) * (0x1p-24 + 0x1p-44) + 0x1p-149);
+			lo = std::max(a - e, std::signbit(code) ? lowest[j] : std::max(lowest[j], 0.0));
+		}
+		else
+		{
+			if ((long)code == zero[j])
+			{
+				lo = hi = 0;
+				return;
+			}
+			// values within half a step of 0 are moved one code away from it
+			if ((long)code == zero[j] - 1 || (long)code == zero[j] + 1)
+				e *= 2;
+			lo = std::max(a - e, lowest[j]);
+			hi = std::min(a + e, highest[j]);
+			// and the codes on either side of 0 hold values of that sign only
+			if (zero[j] >= 0 && (long)code > zero[j])
+				lo = std::max(lo, 0.0);
+			else if (zero[j] >= 0)
+				hi = std::min(hi, -0x1p-1074);
+			return;
+		}
+		hi = std::min(a + e, highest[j]);
+	}
+};
+
+// Reduced-precision copy of a dataset. Every double lies in the range() of
+// its decoded value (an infinite one for columns holding non-finite values),
+// so a comparison the ranges cannot change is decided from the copy alone;
+// closer ones are settled on the doubles, which keeps every result identical
+// to the full-precision one while the doubles are touched only for those few
+// rows.
+class compact_dataset
+{
+public:
+	// With mappedCache (ds came from readDatasetCache) the pages of ds are
+	// dropped as they are encoded, so that the doubles and the copy are not
+	// resident together
+	compact_dataset(const dataset& ds, precision p, bool mappedCache = false);
+
+	const dataset& exact() const { return ds; }
+	precision mode() const { return kind; }
+	size_t bytes() const { return floats.size() * sizeof(float) + words.size() * sizeof(uint16_t); }
+
+	// Calls f with the compact_view<float> or compact_view<uint16_t> of the copy
+	template <class F>
+	auto visit(F f) const
+	{
+		if (kind == precision::float32)
+			return f(compact_view<float>{ floats.data(), ds.n, offset.data(), step.data(), bound.data(), low.data(), high.data(),
+				zero.data() });
+		return f(compact_view<uint16_t>{ words.data(), ds.n, offset.data(), step.data(), bound.data(), low.data(), high.data(),
+			zero.data() });
+	}
+
+	// False if a column holds non-finite values, which no bound covers
+	bool bounded() const;
+
+	// Decoded value j of point i
+	double value(size_t i, size_t j) const
+	{
+		return visit([&](auto view) { return view.value(i, j); });
+	}
+
+	// exact().value(i, j), for the few reads that settle what the copy
+	// cannot. The cache pages they fault in are dropped every few reads.
+	double exactValue(size_t i, size_t j) const
+	{
+		double v = ds.value(i, j);
+		if (mapped && ++reads % kReleaseEvery == 0)
+			releaseExact();
+		return v;
+	}
+
+	// The same rows as columnArgMax(exact(), argmax)
+	void argmax(size_t* out) const;
+
+	// selectRows(exact(), rows), read with exactValue()
+	dataset exactRows(const std::vector<size_t>& rows) const;
+
+	// Drops the cache pages that reads of the doubles faulted back in. The
+	// kernel maps whole page-cache folios, so even a few scattered reads can
+	// bring back megabytes; every operation that reads them ends with this.
+	void releaseExact() const;
+
+private:
+	static const size_t kReleaseEvery = 16;
+
+	dataset ds;
+	precision kind;
+	bool mapped;
+	std::vector<float> floats;
+	std::vector<uint16_t> words;
+	std::vector<double> offset;
+	std::vector<double> step;
+	std::vector<double> bound;
+	std::vector<double> low;
+	std::vector<double> high;
+	std::vector<long> zero;
+	mutable std::atomic<size_t> reads;
+};
+
+#endif
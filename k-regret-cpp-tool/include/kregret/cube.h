@@ -21,9 +21,253 @@
 #define KREGRET_INCLUDE_CUBE_H_
 
 #include <cmath>
+#include <cstdint>
+#include <functional>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <kregret/dataset.h>
 #include <kregret/point.h>
 
+class compact_dataset;
+
+// How cube() searches for the grid size t
+enum class cube_search
+{
+	linear, // t, t+1, t+2, ... as in the original algorithm
+	gallop  // t, t+1, t+3, t+7, ... then bisection on the last gap; the number of
+	        // distinct points is not monotone in t on every dataset, so this can
+	        // settle on a different t than the linear search
+};
+
+struct cube_options
+{
+	cube_search search;
+	int maxPasses; // cap on the number of cubealgorithm() passes
+
+	cube_options() : search(cube_search::linear), maxPasses(256) {}
+};
+
+// Map from packed cube ids to the entries of their cubes, by open addressing.
+// Entries are kept densely in insertion order and clear() keeps the capacity
+// of both arrays, so a map reused across passes and solves stops allocating
+// once it has held the largest pass. Offers the part of the std::map
+// interface the bucketing uses.
+template <class Entry>
+class packed_cells
+{
+public:
+	typedef uint64_t key_type;
+	struct slot { uint64_t first; Entry second; };
+	typedef typename std::vector<slot>::iterator iterator;
+
+	packed_cells() : bits(0) {}
+
+	iterator begin() { return items.begin(); }
+	iterator end() { return items.end(); }
+	size_t size() const { return items.size(); }
+
+	void clear()
+	{
+		items.clear();
+		std::fill(index.begin(), index.end(), 0);
+	}
+
+	iterator find(uint64_t key)
+	{
+		if (index.empty())
+			return end();
+		for (size_t h = home(key);; h = (h + 1) & (index.size() - 1))
+			if (index[h] == 0)
+				return end();
+			else if (items[index[h] - 1].first == key)
+				return begin() + (index[h] - 1);
+	}
+
+	// Adds key with value unless it is present, in which case value is left
+	// untouched as by std::map::try_emplace; the bool tells which
+	template <class Value>
+	std::pair<iterator, bool> try_emplace(uint64_t key, Value&& value)
+	{
+		if (2 * (items.size() + 1) > index.size())
+			grow();
+		size_t h = home(key);
+		for (; index[h] != 0; h = (h + 1) & (index.size() - 1))
+			if (items[index[h] - 1].first == key)
+				return std::make_pair(begin() + (index[h] - 1), false);
+		items.push_back(slot{ key, std::forward<Value>(value) });
+		index[h] = items.size();
+		return std::make_pair(end() - 1, true);
+	}
+
+	template <class Value>
+	std::pair<iterator, bool> emplace(uint64_t key, Value&& value) { return try_emplace(key, std::forward<Value>(value)); }
+
+private:
+	// Fibonacci hashing spreads the consecutive ids of neighbouring cubes
+	size_t home(uint64_t key) const { return (size_t)((key * 0x9E3779B97F4A7C15ULL) >> (64 - bits)); }
+
+	void grow()
+	{
+		bits = std::max(bits + 1, 4);
+		index.assign((size_t)1 << bits, 0);
+		for (size_t i = 0; i < items.size(); ++i)
+		{
+			size_t h = home(items[i].first);
+			while (index[h] != 0)
+				h = (h + 1) & (index.size() - 1);
+			index[h] = i + 1;
+		}
+	}
+
+	std::vector<slot> items;
+	std::vector<size_t> index; // 1 + position in items, or 0 for a free slot
+	int bits;                  // index holds 2^bits slots
+};
+
+// Hash and equality of rows by their coordinates, so that duplicates of an
+// already selected point are found in O(1) regardless of their row index.
+// -0.0 and 0.0 are the same coordinate. With a compact copy the hash and a
+// first comparison use its values, which are equal for equal doubles, so
+// the doubles are read only for rows that may be duplicates.
+struct coordinate_hash
+{
+	const dataset* ds;
+	const compact_dataset* compact;
+	size_t operator()(size_t i) const;
+};
+
+struct coordinate_equal
+{
+	const dataset* ds;
+	const compact_dataset* compact;
+	bool operator()(size_t a, size_t b) const;
+};
+
+// Rows told apart by their coordinates, by open addressing over the row
+// indices. reset() keeps the capacity, so a set reused from pass to pass stops
+// allocating once it has held the largest one.
+class distinct_rows
+{
+public:
+	distinct_rows() : count(0), bits(0), hash{nullptr, nullptr}, equal{nullptr, nullptr} {}
+
+	// Empties the set and compares rows of ds (or of its compact copy) from now on
+	void reset(const dataset& ds, const compact_dataset* compact);
+
+	// Adds row unless a row with the same coordinates is in; true if added
+	bool insert(size_t row);
+
+	size_t size() const { return count; }
+
+private:
+	size_t home(size_t row) const { return (size_t)(((uint64_t)hash(row) * 0x9E3779B97F4A7C15ULL) >> (64 - bits)); }
+	void grow();
+
+	std::vector<size_t> slots; // 1 + row, or 0 for a free slot
+	size_t count;
+	int bits;                  // slots holds 2^bits entries
+	coordinate_hash hash;
+	coordinate_equal equal;
+};
+
+// Buffers the cube passes work in. A cube_solver given a scratch uses it
+// instead of its own, so handing one scratch to successive solvers (one at a
+// time) keeps the capacity of the candidate list, the bucketing maps and the
+// cube order and the set of distinct points from one solve to the next.
+struct cube_scratch
+{
+	typedef packed_cells<size_t> packed_map; // cube id -> representative row
+
+	std::vector<char> inside;
+	std::vector<size_t> candidates;
+	packed_map best;
+	std::vector<packed_map> local;                  // one per worker
+	std::vector<std::vector<size_t>> undecided;     // one per worker
+	std::vector<std::pair<uint64_t, size_t>> ids;
+	std::vector<size_t> order;
+	distinct_rows seen;
+};
+
+// One grid pass, made for the largest K asked for
+struct cube_pass
+{
+	int distinct;              // points found for maxK
+	bool saturated;            // every distinct candidate sits in a cube of its own
+	std::vector<size_t> answer;
+};
+
+// The search for the grid size t over N points in D dimensions: pass(t)
+// returns the pass for t, made for some maxK >= K. Returns the t whose pass
+// answers K, as cube() picks it.
+int searchGrid(size_t D, size_t N, int K, const cube_options& options, const std::function<const cube_pass&(int)>& pass);
+
+// Runs the cube algorithm for any number of K up to maxK over the same data.
+// The column maxima and the filter of points that can fall in a cube are
+// computed once. Every grid pass is made for maxK and kept: a pass for a
+// smaller K stops at a prefix of the same list, so each grid size is bucketed
+// at most once across all the K asked for. With a compact copy of ds (see
+// compact.h) the scans run on the copy, giving the same selection.
+class cube_solver
+{
+public:
+	cube_solver(const dataset& ds, int maxK, const cube_options& options = cube_options(),
+		const compact_dataset* compact = nullptr, cube_scratch* scratch = nullptr);
+
+	// Same selection as cube(ds, K, maxIndex, options), for K <= maxK. grid,
+	// if given, receives the grid size t the answer was taken from.
+	void select(int K, int *maxIndex, int *grid = nullptr);
+
+private:
+	const cube_pass& run(int t);
+
+	dataset ds;
+	cube_options options;
+	int limit;
+	std::vector<size_t> c;          // maximal point in each direction
+	const compact_dataset* compact;
+	std::unique_ptr<cube_scratch> own;
+	cube_scratch* scratch;          // candidates holds the points inside the grid
+	std::map<int, cube_pass> passes;
+};
+
+void cube(const dataset& ds, int K, int *maxIndex, const cube_options& options = cube_options(),
+	const compact_dataset* compact = nullptr, cube_scratch* scratch = nullptr);
+int cubealgorithm(const dataset& ds, int K, size_t L, int t, const size_t *c, size_t *answer);
+
+// The building blocks of a pass, for callers that hold the points in pieces
+// (see shard.h). upper[j] is the largest value in dimension j, which need not
+// belong to a row of ds; L is the last dimension.
+//
+// gridCandidates() lists the rows whose free coordinates lie in [0, upper[j]),
+// the only ones any grid can place. occupiedCells() buckets such rows for grid
+// size t and lists the representative of every occupied cube in counter order,
+// with the D - 1 strip numbers of its cube, most significant first, in keys.
+// cubeAnswer() lists the boundary points c (all but the one for L), then the
+// given cube points unless they repeat the coordinates of an earlier point, up
+// to K, and pads the answer with its first point; it returns the number of
+// distinct points listed.
+void gridCandidates(const dataset& ds, const double* upper, std::vector<size_t>& candidates,
+	const compact_dataset* compact = nullptr, cube_scratch* scratch = nullptr);
+void occupiedCells(const dataset& ds, int t, const double* upper, const size_t* candidates, size_t count,
+	std::vector<size_t>& rows, std::vector<long>& keys, cube_scratch* scratch = nullptr);
+int cubeAnswer(const dataset& ds, int K, size_t L, const size_t* c, const std::vector<size_t>& order, size_t* answer,
+	const compact_dataset* compact = nullptr, cube_scratch* scratch = nullptr);
+
+// Strip b of value v on a grid of t strips of width c (b*c <= v < (b+1)*c,
+// 0 <= b < t), or -1 if v lies outside the grid
+long cubeCell(double v, double c, int t);
+
+// Whether rows[0..count) hold at most limit distinct points by coordinates.
+// Stops at the first point past limit, so a pass can test for saturation on
+// rows that repeat without hashing them all.
+bool atMostDistinct(const dataset& ds, const size_t* rows, size_t count, size_t limit,
+	const compact_dataset* compact = nullptr, cube_scratch* scratch = nullptr);
+
+// Compatibility entry point for callers holding a point array
 void cube(size_t D, size_t N, int K, struct point *p, int *maxIndex);
-int cubealgorithm(size_t D, size_t N, int K, struct point *p, size_t L, int t, struct point *c, struct point *answer);
 
 #endif
@@ -20,8 +20,26 @@
 #ifndef KREGRET_INCLUDE_DATAREADER_H_
 #define KREGRET_INCLUDE_DATAREADER_H_
 
+#include <cstddef>
 #include <vector>
 
+#include <kregret/dataset.h>
+
+// Parses the file straight into a row-major dataset with a single allocation
+dataset readDataset(const char*, const char);
+
+// Outcome of the non-exiting readDataset()
+enum class read_status { ok, cannot_open, no_data };
+
+// Same, but reports an unreadable or empty file instead of exiting; out is
+// only set on success
+read_status readDataset(const char* filename, char sep, dataset& out);
+
+// Reads only slice of slices equal shares of the file's bytes: the rows of
+// the lines that start in it, the first line always going to slice 0. The
+// slices of a file partition its rows in order. A slice without rows is
+// reported as no_data.
+read_status readDatasetSlice(const char* filename, char sep, size_t slice, size_t slices, dataset& out);
 std::vector<std::vector<double>> processData(const char*,const char, size_t&, size_t&);
 
-#endif;
\ No newline at end of file
+#endif
\ No newline at end of file
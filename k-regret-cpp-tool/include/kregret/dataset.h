@@ -0,0 +1,76 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#ifndef KREGRET_INCLUDE_DATASET_H_
+#define KREGRET_INCLUDE_DATASET_H_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <kregret/point.h>
+
+struct dataset_stats;
+
+// Storage order of a dataset buffer.
+enum class layout { row_major, column_major };
+
+// N points in D dimensions held in one 64-byte aligned contiguous buffer.
+// Coordinate j of point i lives at base[i * rowStride + j * colStride], so the
+// same type describes a row-major buffer (rowStride = D, colStride = 1) and a
+// column-major / SoA buffer (rowStride = 1, colStride = N).
+struct dataset
+{
+	size_t d;
+	size_t n;
+	double* base;
+	size_t rowStride;
+	size_t colStride;
+	std::shared_ptr<void> storage; // owns base; empty for borrowed buffers
+	std::shared_ptr<const dataset_stats> stats; // column summary if known (dataset_stats.h);
+	                                            // whoever changes the values drops it
+
+	dataset() : d(0), n(0), base(nullptr), rowStride(0), colStride(0) {}
+
+	double value(size_t i, size_t j) const { return base[i * rowStride + j * colStride]; }
+	double& value(size_t i, size_t j) { return base[i * rowStride + j * colStride]; }
+
+	bool rowMajor() const { return colStride == 1; }
+	bool columnMajor() const { return rowStride == 1; }
+
+	// Contiguous coordinates of point i (row-major only)
+	double* row(size_t i) const { return base + i * rowStride; }
+	// Contiguous values of dimension j (column-major only)
+	double* column(size_t j) const { return base + j * colStride; }
+
+	// Thin point view of row i (row-major only)
+	point at(size_t i) const;
+};
+
+dataset allocateDataset(size_t D, size_t N, layout l = layout::row_major);
+dataset datasetView(double* base, size_t D, size_t N, size_t rowStride, size_t colStride);
+dataset convertLayout(const dataset& ds, layout l);
+dataset datasetFromRows(const std::vector<std::vector<double>>& data, size_t D, size_t N, layout l = layout::row_major);
+dataset datasetFromPoints(const struct point* p, size_t D, size_t N, layout l = layout::row_major);
+dataset selectRows(const dataset& ds, const std::vector<size_t>& rows, layout l = layout::row_major);
+
+void columnArgMax(const dataset& ds, size_t* argmax);
+
+#endif
@@ -0,0 +1,89 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#ifndef KREGRET_INCLUDE_DATASET_CACHE_H_
+#define KREGRET_INCLUDE_DATASET_CACHE_H_
+
+#include <cstdint>
+#include <string>
+
+#include <kregret/dataset.h>
+
+// Binary dataset cache. The file starts with a 64-byte header followed by the
+// D columns of the dataset, each padded to a multiple of 64 bytes, so that a
+// mapped cache is used in place as a column-major dataset. If flag bit 0 is
+// set the columns are followed by the column summary (dataset_stats.h): D
+// maxima, D minima and D sums as doubles, then D argmax rows as uint64.
+//
+//   offset  size  field
+//        0     8  magic "KREGRETB"
+//        8     4  format version
+//       12     4  byte order mark 0x01020304
+//       16     8  D
+//       24     8  N
+//       32     8  column stride in doubles
+//       40     8  FNV-1a hash of the source file, checked by a verifying cacheIsFresh()
+//       48     8  size of the source file in bytes
+//       56     1  separator the source was parsed with
+//       57     1  flags
+//       58     6  reserved
+struct cache_header
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t byteOrder;
+	uint64_t d;
+	uint64_t n;
+	uint64_t colStride;
+	uint64_t sourceHash;
+	uint64_t sourceSize;
+	char separator;
+	uint8_t flags;
+	char reserved[6];
+};
+
+static_assert(sizeof(cache_header) == 64, "cache header must stay 64 bytes");
+
+// Sidecar cache path used for source: source + ".kbin"
+std::string cachePath(const std::string& source);
+
+// True if path starts with a readable cache header of this version
+bool isDatasetCache(const char* path);
+
+// Writes ds to path; returns false if the file cannot be written
+bool writeDatasetCache(const char* path, const dataset& ds, const char* source, char sep);
+
+// Maps the cache at path without copying, with its column summary if it has
+// one. On failure returns false and leaves ds untouched.
+bool readDatasetCache(const char* path, dataset& ds, cache_header* header = nullptr);
+
+// Drops the resident pages holding rows [first, last) of a dataset returned by
+// readDatasetCache. They are read back from the file if touched again. Must
+// not be used on any other dataset.
+void releaseDatasetCache(const dataset& ds, size_t first = 0, size_t last = (size_t)-1);
+
+// True if the sidecar cache of source exists, is at least as new as source,
+// matches its size and was parsed with the same separator. A source replaced
+// by another of the same size with its time kept passes these tests; verify
+// also hashes the source and compares it with the header, at the cost of
+// reading the whole file.
+bool cacheIsFresh(const char* source, char sep, bool verify = false);
+
+#endif
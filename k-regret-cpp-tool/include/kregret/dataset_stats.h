@@ -0,0 +1,74 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#ifndef KREGRET_INCLUDE_DATASET_STATS_H_
+#define KREGRET_INCLUDE_DATASET_STATS_H_
+
+#include <cstddef>
+#include <vector>
+
+#include <kregret/dataset.h>
+
+// Per-column summary of a dataset. The loader fills it in while it parses
+// and the binary cache stores it, so columnArgMax() and everything built on
+// it (the cube boundary points, the axis evaluator, the LP normalization)
+// look the column maxima up instead of scanning the N x D values. argmax[j]
+// is also the extreme point of dimension j that the engines start from.
+struct dataset_stats
+{
+	size_t rows;                // rows summarized
+	std::vector<double> max;
+	std::vector<double> min;
+	std::vector<double> sum;
+	std::vector<size_t> argmax; // first row attaining max, as columnArgMax()
+
+	dataset_stats() : rows(0) {}
+	explicit dataset_stats(size_t D) : rows(0), max(D), min(D), sum(D, 0.0), argmax(D, 0) {}
+
+	// Adds row i, which comes after every row added so far
+	void add(const double* row, size_t i)
+	{
+		for (size_t j = 0; j < max.size(); ++j)
+		{
+			double v = row[j];
+			if (rows == 0 || v > max[j])
+			{
+				max[j] = v;
+				argmax[j] = i;
+			}
+			if (rows == 0 || v < min[j])
+				min[j] = v;
+			sum[j] += v;
+		}
+		rows++;
+	}
+
+	// Folds in the summary of other rows, whose indices are offset by first.
+	// Equal maxima keep the lower row, so the order of merging does not matter.
+	void merge(const dataset_stats& other, size_t first = 0);
+
+	// True if this summarizes all of ds
+	bool covers(const dataset& ds) const { return rows == ds.n && argmax.size() == ds.d; }
+};
+
+// Summary of ds in one pass over its values
+dataset_stats computeStats(const dataset& ds);
+
+#endif
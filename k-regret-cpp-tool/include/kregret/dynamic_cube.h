@@ -0,0 +1,116 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#ifndef KREGRET_INCLUDE_DYNAMIC_CUBE_H_
+#define KREGRET_INCLUDE_DYNAMIC_CUBE_H_
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include <kregret/cube.h>
+#include <kregret/dataset.h>
+
+// Keeps the cube algorithm's answer for a fixed K up to date while points are
+// inserted and erased.
+//
+// Rows keep their ids: the initial points are 0..N-1 and every insertion gets
+// the next id. The state is the one cube() builds for its chosen grid size t:
+// the maximal point c_j of every free dimension and, for each occupied cube,
+// its members and its representative (largest in the last dimension, lowest
+// id on ties), ordered by the t-ary counter. The selection is the boundary
+// points followed by the first distinct representatives in counter order.
+//
+// An update only touches the point's own cube. The selection is walked again
+// (O(K)) only when the changed cube is before the last selected one or the
+// set is short of K, so a point that is not selected can be erased, and a
+// point that does not beat its cube's representative can be inserted, without
+// changing it. A point that moves a boundary c_j shifts every cube and
+// triggers a rebuild, i.e. a fresh cube() run over the live points, as does
+// a grid that no longer yields K points. The grid size is otherwise held, so
+// the set is cube()'s answer for that t; to follow the size cube() would
+// pick, the grid is also rebuilt once the updates since the last rebuild
+// reach a quarter of the live points, which keeps the amortized cost per
+// update constant.
+class dynamic_cube
+{
+public:
+	dynamic_cube(const dataset& ds, int K, const cube_options& options = cube_options());
+
+	// Adds a point of D coordinates and returns its id
+	size_t insert(const double* p);
+
+	// Removes the point with the given id; false if there is no such live point
+	bool erase(size_t id);
+
+	// Ids of the K selected points, padded with the first one as in cube()
+	const std::vector<size_t>& selected() const { return answer; }
+
+	// Copy of the live points in id order, and their ids
+	dataset livePoints(std::vector<size_t>* ids = nullptr) const;
+
+	size_t size() const { return live; }
+	int grid() const { return t; }
+	size_t rebuilds() const { return rebuildCount; }
+
+	// Reruns cube() over the live points
+	void rebuild();
+
+private:
+	struct cube_cell
+	{
+		size_t best;                 // representative
+		std::vector<size_t> members;
+	};
+
+	static constexpr uint64_t kNoCell = ~(uint64_t)0;
+
+	double value(size_t id, size_t j) const { return values[id * d + j]; }
+	uint64_t cellOf(size_t id) const;
+	bool inside(size_t id) const;
+	bool add(size_t id, uint64_t& cell);
+	bool enough() const;
+	void touched(uint64_t cell);
+	void settle();
+	void walk();
+
+	size_t d;
+	int k;
+	cube_options options;
+	std::vector<double> values; // all rows ever added, row-major
+	std::vector<char> alive;
+	size_t live;
+
+	int t;
+	bool packed;                 // cube ids fit in 64 bits; otherwise every update rebuilds
+	std::vector<size_t> c;       // maximal point of each dimension
+	std::map<uint64_t, cube_cell> cells;
+	std::vector<uint64_t> cellOfRow;
+	std::vector<size_t> position; // index of each row in its cube's members
+	size_t candidates;           // live points passing cube()'s grid filter
+
+	std::vector<size_t> answer;
+	size_t distinct;             // points found before padding
+	uint64_t lastCell;           // last cube the walk looked at
+	size_t updates;              // since the last rebuild
+	size_t rebuildCount;
+};
+
+#endif
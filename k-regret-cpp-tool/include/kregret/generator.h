@@ -0,0 +1,52 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#ifndef KREGRET_INCLUDE_GENERATOR_H_
+#define KREGRET_INCLUDE_GENERATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <kregret/dataset.h>
+
+// Synthetic workloads in [0,1]^D, following the generators of Börzsönyi,
+// Kossmann and Stocker ("The Skyline Operator", ICDE 2001).
+//
+//   independent     every coordinate uniform
+//   correlated      points near the diagonal: good in one dimension means
+//                   good in the others, so the skyline is tiny
+//   anticorrelated  points near the plane sum(x) = D/2: good in one dimension
+//                   means bad in another, so the skyline is large
+enum class distribution { independent, correlated, anticorrelated };
+
+// Accepts the names above and the short forms ind, cor and anti
+bool parseDistribution(const std::string& name, distribution& out);
+const char* distributionName(distribution kind);
+
+// N points drawn from kind. The same seed gives the same points for any
+// number of threads.
+dataset generateDataset(distribution kind, size_t D, size_t N, uint64_t seed);
+
+// Writes ds as text, one point per line, with values separated by sep and
+// printed so that they read back exactly. Returns false on a write error.
+bool writeDatasetText(const char* path, const dataset& ds, char sep);
+
+#endif
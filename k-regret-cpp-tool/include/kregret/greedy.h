@@ -0,0 +1,64 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#ifndef KREGRET_INCLUDE_GREEDY_H_
+#define KREGRET_INCLUDE_GREEDY_H_
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include <kregret/dataset.h>
+#include <kregret/kregret_result.h>
+
+// RDP-Greedy: starts from the point that is best in the first dimension and
+// repeatedly adds the point with the largest regret ratio against the points
+// chosen so far, until K points are chosen or every regret ratio is 0.
+//
+// Only skyline points are considered. Each candidate keeps its regret LP from
+// round to round and only the newly chosen point is added to it, so a round
+// costs a few dual pivots per candidate rather than a full solve. Regret
+// ratios only shrink as points are added, so the last ratio (tightened by a
+// dominance test against the new point) bounds the next one; candidates are
+// evaluated in parallel, best bound first, and skipped once their bound falls
+// below the best ratio of the round.
+//
+// The row indices are written to maxIndex, padded with the first point when
+// fewer than K are needed. The result holds copies of the chosen points, their
+// rows, and max_regret, the exact maximum regret ratio of the set.
+//
+// Each round only extends the previous set, so the first k points of a run
+// are the set a run with K = k selects. progress, if given, is called after
+// every round with the number of points chosen so far and their exact maximum
+// regret ratio; a run for the largest K thereby answers every smaller one.
+typedef std::function<void(size_t, double)> greedy_progress;
+
+kregret_result greedy(const dataset& ds, int K, int *maxIndex, const greedy_progress& progress = greedy_progress());
+
+// The rounds of greedy() from a given start: chosen (at least one row of ds)
+// is extended with the candidate with the largest regret ratio until it holds
+// K rows or every ratio is 0. candidates must include the skyline of ds, or
+// the ratio is only that of the candidates. Returns the exact maximum regret
+// ratio of chosen over the candidates. Other engines use it to spend the slots
+// their own rule leaves free.
+double greedyExtend(const dataset& ds, const std::vector<size_t>& candidates, std::vector<size_t>& chosen, size_t K,
+	const greedy_progress& progress = greedy_progress());
+
+#endif
@@ -0,0 +1,62 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#ifndef KREGRET_INCLUDE_HITTING_SET_H_
+#define KREGRET_INCLUDE_HITTING_SET_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <kregret/dataset.h>
+#include <kregret/kregret_result.h>
+
+// Approximate k-regret through the hitting-set formulation. The utility space
+// is discretized into M directions drawn from the non-negative unit sphere
+// (in the space where every column maximum is 1), plus the D axes, which
+// random draws seldom come near. For a regret ratio eps, direction u is
+// served by its eps-top set, the skyline points scoring at least (1 - eps)
+// times the best score on u, and a set of points has sampled regret at most
+// eps exactly when it hits every eps-top set. Scores come from
+// the blocked utility kernels, in parallel over blocks of directions.
+//
+// The hitting set is found by greedy set cover with a lazily updated priority
+// queue, and eps is bisected for the smallest value whose cover has at most K
+// points. Only the pairs within the eps being tried are kept: they are first
+// collected up to a small bound, and collected again with the bound doubled
+// while the cover needs more than K points, up to the regret of a cheap
+// K-point set (the column maxima, or the greedy cover at the first bound cut
+// to K points). Memory thus follows the answer's eps, not the skyline size.
+// The remaining slots are then filled greedily at the largest eps that needed
+// more than K points, so exactly K distinct points are returned.
+//
+// When at most K points already serve every sampled direction exactly, the
+// samples cannot tell sets apart: the column maxima are added to that cover
+// and the slots left are filled by greedyExtend() (see greedy.h) on the exact
+// regret ratio, so fewer than K distinct points are returned only once the
+// exact ratio is 0.
+//
+// directions = 0 picks M = max(2048, 16 K). The row indices are written to
+// maxIndex, padded with the first point if needed. The result holds copies
+// of the chosen points and their rows, and max_regret is the regret ratio of
+// the set over the sampled directions and the axes, a lower bound on the
+// true ratio.
+kregret_result hittingSet(const dataset& ds, int K, int *maxIndex, size_t directions = 0, uint64_t seed = 1);
+
+#endif
@@ -0,0 +1,65 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#ifndef KREGRET_INCLUDE_KDTREE_H_
+#define KREGRET_INCLUDE_KDTREE_H_
+
+#include <cstddef>
+#include <vector>
+
+// Static kd-tree over a copy of N points in D dimensions, for exact nearest
+// point (Euclidean) queries. Nodes split the dimension of largest spread at
+// the median, and leaves hold a small contiguous block of points, stored in
+// tree order so that a leaf scan touches one run of memory. Every node keeps
+// the bounding box of its points: for query points far outside the data, as
+// in the Sphere algorithm, the distance to a splitting plane is a useless
+// bound while the distance to a box still prunes. Queries are read-only and
+// may run concurrently.
+class kd_tree
+{
+public:
+	// points is row-major, N x D
+	kd_tree(const double* points, size_t N, size_t D);
+
+	// Index (into the original points) of the point nearest to q; the lowest
+	// index among equally near points
+	size_t nearest(const double* q) const;
+
+	size_t size() const { return index.size(); }
+
+private:
+	struct node
+	{
+		size_t begin, end; // range of tree-order points below this node
+		size_t left, right; // children, none for leaves
+	};
+
+	size_t build(size_t begin, size_t end);
+	void search(size_t n, const double* q, size_t& best, double& bestDistance) const;
+	double boxDistance(size_t n, const double* q) const;
+
+	size_t d;
+	std::vector<double> coords;  // points in tree order
+	std::vector<size_t> index;   // original index of each tree-order point
+	std::vector<node> nodes;
+	std::vector<double> boxes;   // per node: D lower then D upper bounds
+};
+
+#endif
@@ -0,0 +1,143 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#ifndef KREGRET_INCLUDE_KERNELS_H_
+#define KREGRET_INCLUDE_KERNELS_H_
+
+#include <cstddef>
+#include <type_traits>
+
+// Point primitives specialized for the dimension at compile time.
+//
+// Each kernel takes the dimension twice: as the template argument FD, which is
+// 2..8 for the common cases and 0 for "only known at run time", and as the
+// run-time D, which is used only when FD is 0. With a fixed FD the loops
+// unroll fully and the comparisons become branch-free. A hot loop calls
+// dispatchDimension() once, outside the loop, and runs the specialized body.
+//
+// Functions whose loops are worth vectorizing are marked
+// KREGRET_TARGET_CLONES: on x86 Linux with GCC or Clang the compiler emits an
+// AVX-512, an AVX2 and a baseline copy and the loader picks one by CPUID when
+// the program starts. The kernels below are forced inline so that each copy
+// gets its own instruction set. Elsewhere the macro expands to nothing.
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) \
+	&& defined(__linux__) && !defined(KREGRET_NO_TARGET_CLONES)
+#define KREGRET_TARGET_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define KREGRET_TARGET_CLONES
+#endif
+
+// KREGRET_INLINE_LAMBDA goes after a lambda's parameter list, for bodies
+// handed to dispatchDimension() from inside a cloned function
+#if defined(__GNUC__) || defined(__clang__)
+#define KREGRET_ALWAYS_INLINE __attribute__((always_inline)) inline
+#define KREGRET_INLINE_LAMBDA __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define KREGRET_ALWAYS_INLINE __forceinline
+#define KREGRET_INLINE_LAMBDA
+#else
+#define KREGRET_ALWAYS_INLINE inline
+#define KREGRET_INLINE_LAMBDA
+#endif
+
+template <size_t FD>
+using dimension = std::integral_constant<size_t, FD>;
+
+// Calls f(dimension<D>()) for D in 2..8 and f(dimension<0>()) otherwise
+template <class F>
+KREGRET_ALWAYS_INLINE auto dispatchDimension(size_t D, F&& f) -> decltype(f(dimension<0>()))
+{
+	switch (D)
+	{
+	case 2: return f(dimension<2>());
+	case 3: return f(dimension<3>());
+	case 4: return f(dimension<4>());
+	case 5: return f(dimension<5>());
+	case 6: return f(dimension<6>());
+	case 7: return f(dimension<7>());
+	case 8: return f(dimension<8>());
+	default: return f(dimension<0>());
+	}
+}
+
+// a . w
+template <size_t FD>
+KREGRET_ALWAYS_INLINE double dotKernel(const double* a, const double* w, size_t D)
+{
+	const size_t n = FD ? FD : D;
+	double s = 0.0;
+	for (size_t j = 0; j < n; ++j)
+		s += a[j] * w[j];
+	return s;
+}
+
+// No a[j] < b[j], with the coordinates of a stride apart: a[j] >= b[j] for
+// every j unless a NaN is involved, which like the original dominates() does
+// not count as a miss. A fixed dimension tests every coordinate without
+// branching; a run-time one stops at the first miss.
+template <size_t FD>
+KREGRET_ALWAYS_INLINE bool dominatesKernel(const double* a, size_t stride, const double* b, size_t D)
+{
+	if (FD == 0)
+	{
+		for (size_t j = 0; j < D; ++j)
+			if (a[j * stride] < b[j])
+				return false;
+		return true;
+	}
+	bool all = true;
+	for (size_t j = 0; j < FD; ++j)
+		all &= !(a[j * stride] < b[j]);
+	return all;
+}
+
+// Lexicographic comparison: -1, 0 or 1 as in pointcmp()
+template <size_t FD>
+KREGRET_ALWAYS_INLINE int compareKernel(const double* a, const double* b, size_t D)
+{
+	const size_t n = FD ? FD : D;
+	for (size_t j = 0; j < n; ++j)
+	{
+		if (a[j] < b[j]) return -1;
+		if (a[j] > b[j]) return 1;
+	}
+	return 0;
+}
+
+// Squared Euclidean distance, giving up (returning a value > limit) as soon as
+// the partial sum passes limit
+template <size_t FD>
+KREGRET_ALWAYS_INLINE double distanceKernel(const double* a, const double* b, double limit, size_t D)
+{
+	if (FD == 0)
+	{
+		double s = 0.0;
+		for (size_t j = 0; j < D && s <= limit; ++j)
+			s += (a[j] - b[j]) * (a[j] - b[j]);
+		return s;
+	}
+	double s = 0.0;
+	for (size_t j = 0; j < FD; ++j)
+		s += (a[j] - b[j]) * (a[j] - b[j]);
+	return s;
+}
+
+#endif
@@ -20,17 +20,26 @@
 #ifndef KREGRET_INCLUDE_KREGRET_RESULT_H
 #define KREGRET_INCLUDE_KREGRET_RESULT_H
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <vector>
+#include <kregret/dataset.h>
 #include <kregret/point.h>
 struct kregret_result
 {
 	std::vector<point> result_points;
+	std::vector<size_t> result_indices; // rows of the input, when known
 	double max_regret;
+	std::shared_ptr<void> storage;      // owns the coordinates of result_points, if copied
 
 	kregret_result() : result_points(0), max_regret(0) {}
 
 	void addPoint(point p);
 	void calculateMaxRegretRatio(size_t N, struct point* p);
+	void calculateMaxRegretRatio(const dataset& ds);
+	void calculateExactMaxRegretRatio(const dataset& ds);
+	void calculateSampledMaxRegretRatio(const dataset& ds, size_t samples, uint64_t seed);
 
 };
 
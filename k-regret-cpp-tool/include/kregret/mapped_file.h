@@ -0,0 +1,48 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#ifndef KREGRET_INCLUDE_MAPPED_FILE_H_
+#define KREGRET_INCLUDE_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <memory>
+
+// Read-only view of a whole file. On POSIX systems the file is memory-mapped;
+// elsewhere it is read into a buffer. Copies share the same mapping, which is
+// released when the last copy goes away.
+struct mapped_file
+{
+	const char* data;
+	size_t size;
+	std::shared_ptr<void> handle;
+
+	mapped_file() : data(nullptr), size(0) {}
+
+	bool isOpen() const { return handle != nullptr; }
+};
+
+// Maps filename, returning a closed mapped_file if it cannot be opened
+mapped_file mapFile(const char* filename);
+
+// Tells the OS the pages fully inside [begin, end) will not be read again.
+// They are dropped from the resident set and reloaded if touched later.
+void releasePages(const mapped_file& file, const char* begin, const char* end);
+
+#endif
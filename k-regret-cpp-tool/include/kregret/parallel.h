@@ -0,0 +1,44 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+#ifndef KREGRET_INCLUDE_PARALLEL_H_
+#define KREGRET_INCLUDE_PARALLEL_H_
+
+#include <cstddef>
+#include <functional>
+
+// Number of threads used by the parallel stages: the value given to
+// setWorkerCount(), or one per hardware thread
+size_t workerCount();
+
+// Sets the number of threads (0 restores the default). Takes effect on the
+// next parallel stage; must not be called while one is running.
+void setWorkerCount(size_t n);
+
+// Splits [begin, end) into chunks and runs body on them on the shared
+// work-stealing pool, returning when all of them are done. body receives a
+// chunk and the number of the worker running it, which is below
+// workerCount(). A worker may run several chunks, in no particular order, so
+// results that must not depend on the thread count are reduced per worker and
+// combined with an order-independent rule, or written per element or block.
+// Without a grain there are about four chunks per worker.
+void parallelFor(size_t begin, size_t end, const std::function<void(size_t, size_t, size_t)>& body);
+void parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t, size_t)>& body);
+
+#endif
@@ -0,0 +1,92 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#ifndef KREGRET_INCLUDE_PLANAR_H_
+#define KREGRET_INCLUDE_PLANAR_H_
+
+#include <cstddef>
+#include <vector>
+
+#include <kregret/dataset.h>
+#include <kregret/kregret_result.h>
+
+// Exact k-regret selection for two-dimensional data. Up to scale a utility is
+// u = (1 - t, t) with t in [0, 1], and the best score of the input at t is
+// attained by the vertices of the upper-right convex hull, one per range of
+// t. For a bound eps, the directions where a point scores within a factor
+// 1 - eps of the best form an interval of t around the direction it serves
+// best, so a set reaches eps exactly when its intervals cover [0, 1], and the
+// smallest such set is found by a greedy sweep. The smallest eps reachable
+// with K points is then bracketed by bisection, each feasible step dropping
+// to the exact ratio of the set it found, until the bracket is tight to
+// rounding.
+//
+// Every skyline point is a candidate: a point off the hull can still cover
+// more than either hull vertex next to it. The skyline is found with one
+// sort, after a pass over buckets of x has removed most of what it dominates.
+class planar_solver
+{
+public:
+	// ds must have two dimensions, and planarApplies(ds)
+	explicit planar_solver(const dataset& ds);
+
+	// Writes the rows of an optimal set of K points to maxIndex, padded with
+	// the first point when fewer already reach the optimum, and returns its
+	// exact maximum regret ratio over all non-negative linear utilities
+	double select(int K, int *maxIndex) const;
+
+	size_t skylineSize() const { return x.size(); }
+	size_t hullSize() const { return hull.size(); }
+
+private:
+	struct span
+	{
+		double lo, hi; // covered directions; empty when lo > hi
+	};
+
+	struct corner
+	{
+		double t, best; // a direction and the best score there
+	};
+
+	double start(size_t k) const { return corners[k].t; }
+	double end(size_t k) const { return corners[k + 1].t; }
+	double ratio(size_t s, size_t i) const;
+	span interval(size_t s, double c, size_t hint[2]) const;
+	bool cover(double eps, int K, std::vector<size_t>& chosen, std::vector<size_t>& hints) const;
+	double regret(const std::vector<size_t>& chosen) const;
+
+	std::vector<double> x, y;   // skyline, x decreasing and y increasing
+	std::vector<size_t> rows;   // their rows in the input
+	std::vector<size_t> hull;   // skyline positions of the hull vertices
+	std::vector<double> breaks;  // breaks[k]: the t where hull vertices k and k + 1 tie
+	std::vector<corner> corners; // the ends of the hull vertex ranges: 0, breaks, 1
+	std::vector<size_t> owner;   // per skyline point, the last hull vertex at or before it
+};
+
+// True if ds has two columns and no negative values, where regret ratios
+// are those of the model above and the exact engine replaces cube
+bool planarApplies(const dataset& ds);
+
+// One selection with planar_solver. The result holds copies of the chosen
+// points, their rows, and max_regret, the exact maximum regret ratio.
+kregret_result planar(const dataset& ds, int K, int *maxIndex);
+
+#endif
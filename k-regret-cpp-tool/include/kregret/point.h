@@ -21,6 +21,7 @@
 #ifndef KREGRET_INCLUDE_POINT_H_
 #define KREGRET_INCLUDE_POINT_H_
 
+#include <cstddef>
 #include <vector>
 
 struct point
@@ -0,0 +1,110 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#ifndef KREGRET_INCLUDE_QUERY_SERVER_H_
+#define KREGRET_INCLUDE_QUERY_SERVER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+
+#include <kregret/cube.h>
+#include <kregret/dataset.h>
+
+// Settings shared by every query a server answers
+struct server_settings
+{
+	std::string engine;    // engine and evaluator of a query that names none
+	std::string evaluator;
+	cube_options options;
+	size_t samples;      // utilities drawn by the sampled evaluator
+	size_t hsDirections; // directions for hs, 0 for its default
+	uint64_t seed;
+	bool useCache;       // loads take a fresh .kbin sidecar
+	bool verifyCache;    // and check it against a hash of the source
+
+	server_settings()
+		: engine("cube"), evaluator("axis"), samples(100000), hsDirections(0), seed(1), useCache(true), verifyCache(false) {}
+};
+
+// Answers k-regret queries against datasets held in memory. Requests and
+// replies are single lines:
+//
+//   load NAME PATH [SEP]                     ok name=NAME n=N d=D
+//   query NAME K [ENGINE [EVALUATOR]]        ok k=K regret=R cached=0|1 time_us=T indices=I,J,...
+//   datasets                                 ok NAME:N:D ...
+//   ping                                     ok
+//   quit                                     closes the connection
+//   shutdown                                 stops the server
+//
+// ENGINE is cube, greedy, sphere or hs and EVALUATOR is axis, exact or
+// sampled, as on the command line; omitted, they default to the settings'. Failures reply
+// "error MESSAGE". A selection is cached per (dataset, K, engine) and its
+// regret per evaluator, so a repeated query is a map lookup; concurrent
+// queries for the same entry compute it once. The skyline, column maxima and
+// sampled best scores of a dataset are computed on first use and kept.
+// Loading a name again replaces the dataset and drops its cache.
+//
+// Connections are served on their own threads; the computations run on the
+// shared pool of parallel.h.
+class query_server
+{
+public:
+	explicit query_server(const server_settings& settings = server_settings());
+
+	// Loads path (or its fresh .kbin sidecar, as the settings allow) under name;
+	// on failure returns false and sets error
+	bool load(const std::string& name, const std::string& path, char sep, std::string& error);
+
+	// Answers one request line; the reply has no trailing newline. quit and
+	// shutdown are handled by the serve functions.
+	std::string handle(const std::string& line);
+
+	// Answers requests read from in on out, one per line, until end of input,
+	// quit or shutdown
+	void serveStream(std::istream& in, std::ostream& out);
+
+	// Listens on a Unix domain socket at path until a client sends shutdown;
+	// returns false and sets error if the socket cannot be set up
+	bool serveSocket(const std::string& path, std::string& error);
+
+private:
+	struct served_dataset;
+
+	std::shared_ptr<served_dataset> find(const std::string& name);
+	std::string query(const std::string& name, long long K, const std::string& engine, const std::string& evaluator);
+	void serveConnection(int fd);
+
+	server_settings settings;
+	std::mutex lock;
+	std::map<std::string, std::shared_ptr<served_dataset>> datasets;
+	std::atomic<bool> stopping;
+	int listener;
+	std::set<int> connections; // open client sockets, closed on shutdown
+	std::condition_variable drained; // signalled when a connection ends
+};
+
+#endif
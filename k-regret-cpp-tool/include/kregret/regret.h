@@ -0,0 +1,151 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#ifndef KREGRET_INCLUDE_REGRET_H_
+#define KREGRET_INCLUDE_REGRET_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <kregret/dataset.h>
+
+// Linear program for the regret ratio of one point q against a selected set S:
+//
+//     maximize q.u  subject to  s.u <= 1 for every s in S,  u >= 0
+//
+// Scaling any utility u so that the best selected point scores 1 shows that
+// the regret ratio of q is 1 - 1/opt when opt > 1 and 0 otherwise. Because
+// the right-hand sides are all 1 the origin is feasible and no phase one is
+// needed. The solver keeps a compact (Tucker) tableau with one column per
+// non-basic variable, so a pivot costs O(|S| * D).
+//
+// Constraints may also be added after solve(). The new row is rewritten in
+// terms of the current basis; if the old optimum violates it, the next solve()
+// restores feasibility with dual simplex pivots from there instead of
+// starting over, which is what makes growing S one point at a time cheap.
+class regret_lp
+{
+public:
+	// Coordinates are multiplied by scale (one factor per dimension) first
+	regret_lp(const double* q, size_t D, const double* scale);
+
+	// Adds the constraint s.u <= 1
+	void addConstraint(const double* s);
+
+	// Solves to optimality and returns the regret ratio of q (1 if unbounded)
+	double solve();
+
+	size_t constraints() const { return m; }
+
+private:
+	void pivot(size_t r, size_t c);
+	bool dualSimplex();
+	void primalSimplex();
+	void restart();
+
+	size_t d;
+	size_t m;                      // number of constraints
+	std::vector<double> t;         // (m + 1) x (d + 1) tableau; the last row is the objective
+	std::vector<double> scale;
+	std::vector<double> objective; // scaled q
+	std::vector<double> rows;      // scaled constraints, m x d, kept for a cold restart
+	std::vector<size_t> basic;     // variable of each row: u_j is j, slack i is d + i
+	std::vector<size_t> nonbasic;  // variable of each column
+	bool unbounded;
+
+	double& at(size_t i, size_t j) { return t[i * (d + 1) + j]; }
+};
+
+// Per-dimension factors that bring every column maximum of ds to 1. The set
+// of linear utilities is closed under positive per-dimension scaling, so this
+// leaves every regret ratio unchanged while keeping the LPs well conditioned.
+std::vector<double> normalization(const dataset& ds);
+
+// Upper bound on the regret ratio of point q of ds against selected:
+// 1 - max over s of min_j s_j / q_j. It is 0 when some s dominates q.
+double regretUpperBound(const dataset& ds, size_t q, const dataset& selected);
+
+// True if point q of ds lies on or below a segment between two selected
+// points, so that some convex combination of the selected set bounds it and
+// its regret ratio is 0. Costs O(|S|^2 * D) and is tried only for sets of at
+// most 64 points. Bounding q by a combination of more points is exactly the
+// condition the LP below tests, so a larger test would cost as much as it.
+bool belowSelectedHull(const dataset& ds, size_t q, const dataset& selected);
+
+// Exact regret ratio of point q of ds against the selected set
+double regretRatio(const dataset& ds, size_t q, const dataset& selected);
+
+// Maximum regret ratio of the selected rows over the D axis-aligned utilities
+// only, a lower bound on the true ratio. argmax holds the row with the largest
+// value in each dimension (see columnArgMax).
+double axisMaxRegretRatio(const dataset& ds, const size_t* argmax, const std::vector<size_t>& rows);
+
+// Exact maximum regret ratio of the selected rows over all non-negative
+// linear utilities. Only skyline points of ds can attain the maximum; pass
+// them in candidates if they are already known, otherwise the skyline is
+// computed here. Candidates dominated by a selected point are dropped, the
+// rest are solved in parallel, most promising first, and skipped once their
+// upper bound cannot beat the best ratio found or they lie below the hull of
+// the selected set (see belowSelectedHull).
+double exactMaxRegretRatio(const dataset& ds, const dataset& selected, const std::vector<size_t>* candidates = nullptr);
+
+// Result of scoring a selected set on randomly drawn utilities
+struct sampled_regret
+{
+	double maxRegret;  // largest regret ratio among the sampled utilities
+	size_t samples;
+	double confidence; // e.g. 0.95
+	double tail;       // with that confidence, at most this fraction of utilities
+	                   // (under the sampling distribution) has a larger regret ratio
+};
+
+// Estimates the maximum regret ratio of the selected rows from M utilities
+// drawn uniformly from the non-negative part of the unit sphere, in the space
+// where every column maximum is 1. Scores are computed by a cache-blocked
+// kernel (a max-reduction over the N x D by D x M product) that runs across
+// threads; the draw is reproducible for a given seed regardless of threads.
+// candidates restricts the "best overall" scan, e.g. to the skyline, which
+// gives the same maxima; by default the skyline is computed here.
+sampled_regret sampledMaxRegretRatio(const dataset& ds, const dataset& selected, size_t M, uint64_t seed,
+	double confidence = 0.95, const std::vector<size_t>* candidates = nullptr);
+
+// The same estimate for many selected sets over one dataset. The constructor
+// draws the utilities and finds the best overall score of each once; every
+// evaluate() then only scores the selected points against the same draw, and
+// returns what sampledMaxRegretRatio would for that set.
+class regret_sampler
+{
+public:
+	regret_sampler(const dataset& ds, size_t M, uint64_t seed, double confidence = 0.95,
+		const std::vector<size_t>* candidates = nullptr);
+
+	sampled_regret evaluate(const dataset& selected) const;
+
+private:
+	size_t d;
+	size_t samples;
+	uint64_t seed;
+	double confidence;
+	std::vector<double> scale;
+	std::vector<double> bestAll; // best overall score of each utility
+};
+
+#endif
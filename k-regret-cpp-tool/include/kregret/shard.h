@@ -0,0 +1,118 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#ifndef KREGRET_INCLUDE_SHARD_H_
+#define KREGRET_INCLUDE_SHARD_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <kregret/cube.h>
+#include <kregret/data_reader.h>
+#include <kregret/dataset.h>
+
+// Sharded cube selection. Each shard is a worker process holding one slice
+// of the input (see readDatasetSlice); a coordinator drives them over pipes
+// and only ever holds a small candidate set:
+//
+//   summary   each shard reports its size and its column maxima with their
+//             rows, giving the global maximal points c
+//   grid      each shard keeps its rows inside the grid of the global maxima
+//   pass t    each shard reports the representative of every cube it
+//             occupies for grid size t with its coordinates; the coordinator
+//             keeps the best one per cube and walks them as cube() does
+//   skyline   each shard reports its skyline; their union holds the skyline
+//             of the whole input, which is all the exact and sampled
+//             evaluators need
+//
+// Rows are numbered as in the whole input, the slices taking them in order,
+// and every tie is broken on those numbers, so the selection is the one
+// cube() makes over the whole input.
+
+// Loads slice of slices of path: its rows, or the same share of the rows of
+// a binary cache (given directly or as a fresh sidecar when useCache is
+// set). A slice without rows loads as an empty dataset.
+read_status loadShard(const char* path, char sep, size_t slice, size_t slices, bool useCache, dataset& out);
+
+// Worker side: reports how loading the slice went on out and, if it loaded,
+// answers the coordinator's requests on in until it is told to stop or in ends
+void serveShard(read_status status, const dataset& slice, FILE* in, FILE* out);
+
+class shard_coordinator
+{
+public:
+	shard_coordinator();
+	~shard_coordinator();
+
+	// Starts one worker per slice by running program --shard-worker I/M on
+	// path, with threads worker threads each, and gathers their summaries.
+	// Returns false and sets error if a worker cannot be started or loaded.
+	bool start(const std::string& program, const std::string& path, char sep, size_t shards, size_t threads,
+		bool useCache, std::string& error);
+
+	size_t size() const { return n; }
+	size_t dimensions() const { return d; }
+
+	// Row with the largest value in each dimension, as columnArgMax()
+	const std::vector<size_t>& argmax() const { return c; }
+
+	// The rows cube(input, K, ..., options) selects
+	bool cube(int K, const cube_options& options, std::vector<size_t>& rows, std::string& error);
+
+	// Coordinates of rows the coordinator has seen: the column maxima and
+	// the selected rows
+	dataset points(const std::vector<size_t>& rows) const;
+
+	// The union of the shard skylines and, in rows, their input rows
+	bool skylines(dataset& points, std::vector<size_t>& rows, std::string& error);
+
+	// Stops the workers
+	void stop();
+
+private:
+	struct worker
+	{
+		int pid;
+		FILE* in;     // requests to the worker
+		FILE* out;    // its replies
+		size_t first; // input row of its first row
+		size_t n;
+	};
+
+	// Both throw std::runtime_error if the worker is gone
+	void send(size_t shard, const void* data, size_t bytes);
+	void receive(size_t shard, void* data, size_t bytes);
+	const cube_pass& pass(int t, int K);
+
+	std::vector<worker> workers;
+	size_t n;
+	size_t d;
+	std::vector<size_t> c;
+	std::vector<double> upper;                     // column maxima
+	size_t candidates;                             // rows inside the grid, over all shards
+	std::map<size_t, std::vector<double>> known;   // coordinates by input row
+	std::map<int, cube_pass> passes;
+};
+
+#endif
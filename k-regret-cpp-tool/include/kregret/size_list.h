@@ -0,0 +1,33 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#ifndef KREGRET_INCLUDE_SIZE_LIST_H_
+#define KREGRET_INCLUDE_SIZE_LIST_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Parses a list of sizes: a size, a range FIRST:LAST[:STEP] or a
+// comma-separated list of either (e.g. 5:200:5 or 10,20,50). The sizes are
+// returned sorted, without duplicates. On failure error says why.
+bool parseSizes(const std::string& arg, std::vector<size_t>& sizes, std::string& error);
+
+#endif
@@ -0,0 +1,113 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#ifndef KREGRET_INCLUDE_SOLVER_H_
+#define KREGRET_INCLUDE_SOLVER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <kregret/cube.h>
+#include <kregret/dataset.h>
+#include <kregret/kregret_result.h>
+
+// Outcome of a solver call. Nothing in this interface exits the process or
+// lets an exception escape.
+enum class solver_status
+{
+	ok,
+	cannot_open,        // the file cannot be read
+	no_data,            // no valid rows
+	too_few_dimensions, // fewer than 2 columns
+	invalid_k,          // K is not between 1 and N
+	invalid_view,       // null buffer or a zero stride
+	out_of_memory,
+	internal_error      // any other failure inside an engine
+};
+
+// One line describing status, e.g. for a log
+const char* solverStatusMessage(solver_status status);
+
+// cube runs the exact two-dimensional engine where planarApplies()
+enum class solver_engine { cube, greedy, sphere, hitting_set };
+
+// How kregret_result::max_regret is filled in: over the D axis utilities, all
+// utilities (exact LP bound) or sampled ones
+enum class solver_evaluator { axis, exact, sampled };
+
+struct solver_settings
+{
+	solver_engine engine;
+	solver_evaluator evaluator;
+	cube_options options;
+	size_t samples;      // utilities drawn by the sampled evaluator
+	size_t hsDirections; // directions for hitting_set, 0 for its default
+	uint64_t seed;
+
+	solver_settings()
+		: engine(solver_engine::cube), evaluator(solver_evaluator::axis), samples(100000), hsDirections(0), seed(1) {}
+};
+
+// Reads path, or its fresh .kbin sidecar unless useCache is false, the way
+// the command line does; verifyCache also checks the sidecar against a hash
+// of path (see cacheIsFresh). out is only set on success.
+solver_status loadDataset(const char* path, char sep, dataset& out, bool useCache = true, bool verifyCache = false);
+
+// k-regret selection for programs linking core. The points are read in place
+// from the caller's buffer: any layout given by a row and a column stride,
+// e.g. (D, 1) for row-major or (1, N) for column-major values. The solver
+// keeps its working buffers between calls, so solving again, on the same or
+// other data of similar size, reuses their capacity; filling the same result
+// reuses its vectors too.
+//
+//   kregret_solver solver;
+//   kregret_result result;
+//   if (solver.solve(values, D, N, D, 1, 10, result) != solver_status::ok) ...
+//
+// result.result_indices receives the K selected rows, result.max_regret the
+// ratio of the configured evaluator. For row-major input result.result_points
+// point into the caller's buffer and stay valid as long as it does; other
+// layouts copy the K selected rows into result.storage. A solver is not meant
+// to be used from two threads at once; the engines themselves run on the
+// shared pool of parallel.h.
+class kregret_solver
+{
+public:
+	explicit kregret_solver(const solver_settings& settings = solver_settings());
+
+	solver_status solve(const dataset& points, int K, kregret_result& result);
+	solver_status solve(const double* values, size_t D, size_t N, size_t rowStride, size_t colStride, int K,
+		kregret_result& result);
+
+	const solver_settings& settings() const { return config; }
+	void setSettings(const solver_settings& settings) { config = settings; }
+
+private:
+	solver_status run(const dataset& points, int K, kregret_result& result);
+
+	solver_settings config;
+	cube_scratch scratch;
+	std::vector<int> indices;
+	std::vector<size_t> rows;
+	std::vector<size_t> argmax;
+};
+
+#endif
@@ -0,0 +1,50 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#ifndef KREGRET_INCLUDE_SPHERE_H_
+#define KREGRET_INCLUDE_SPHERE_H_
+
+#include <kregret/dataset.h>
+#include <kregret/kregret_result.h>
+#include <kregret/point.h>
+
+// Sphere-style selection (after Xie et al., SIGMOD 2018) for large K. With
+// every column maximum scaled to 1, the D boundary points are taken first.
+// Then directions u are drawn from the non-negative part of the unit sphere
+// and, for each, the skyline point nearest to the far-away point R * u is
+// added. Since |p - Ru|^2 = R^2 - 2R u.p + |p|^2, that point nearly maximizes
+// the utility u, and covering the sphere densely enough bounds the regret
+// independently of N. Nearest points come from a kd-tree, queried for a batch
+// of directions at a time across threads; the directions are drawn from a
+// fixed seed, so the selection is reproducible.
+//
+// Drawing stops once a whole batch of directions finds no new point. As in
+// Sphere, the slots left are then filled greedily by the largest regret ratio
+// (greedyExtend(), see greedy.h), until K points are chosen or the ratio is 0.
+//
+// The row indices are written to maxIndex, padded with the first point when
+// fewer than K distinct points are needed. The result holds copies of the
+// chosen points and their rows; max_regret is not computed.
+kregret_result sphere(const dataset& ds, int K, int *maxIndex);
+
+// Compatibility entry point for callers holding a point array
+kregret_result sphere(size_t D, size_t N, int K, struct point *p, int *maxIndex);
+
+#endif
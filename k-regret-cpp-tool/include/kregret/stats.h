@@ -0,0 +1,110 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#ifndef KREGRET_INCLUDE_STATS_H_
+#define KREGRET_INCLUDE_STATS_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// Run statistics for --stats: time spent per phase and counters kept by the
+// algorithms. Nothing is recorded until enableStats() is called; until then a
+// timer or counter costs one load of a flag. Hot loops count into locals and
+// publish once per pass, so enabling them does not slow the loops either.
+// Building with KREGRET_NO_STATS removes the instrumentation altogether.
+enum class stat_phase
+{
+	parse,      // text datasets read by readDataset / processData
+	cache_read, // binary dataset caches mapped by readDatasetCache
+	convert,    // layout and point-array conversions
+	skyline,    // skyline computation (prefilter and evaluators)
+	select,     // the selection algorithm as a whole
+	cube_pass,  // bucketing and walking one cube grid (within select)
+	resolve,    // mapping selected rows back to input indices
+	evaluate,   // regret evaluation
+	count
+};
+
+enum class stat_counter
+{
+	t_values,       // grid sizes tried by the cube search
+	cells_walked,   // occupied cubes visited while collecting points
+	cells_occupied, // non-empty cubes over all passes
+	points_scanned, // points bucketed over all passes
+	dedup_hits,     // cube points dropped as duplicates of earlier ones
+	count
+};
+
+// Set by enableStats(); read through statsEnabled()
+extern std::atomic<bool> statsFlag;
+
+#ifdef KREGRET_NO_STATS
+inline bool statsEnabled() { return false; }
+#else
+inline bool statsEnabled() { return statsFlag.load(std::memory_order_relaxed); }
+#endif
+
+void enableStats();
+
+void addStatTime(stat_phase phase, uint64_t nanoseconds);
+void addStat(stat_counter counter, uint64_t amount);
+
+inline void countStat(stat_counter counter, uint64_t amount)
+{
+	if (statsEnabled())
+		addStat(counter, amount);
+}
+
+// Adds the lifetime of the object to a phase
+class stat_timer
+{
+public:
+	explicit stat_timer(stat_phase p) : phase(p), running(statsEnabled())
+	{
+		if (running)
+			start = std::chrono::steady_clock::now();
+	}
+
+	~stat_timer()
+	{
+		if (running)
+			addStatTime(phase, (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - start).count());
+	}
+
+	stat_timer(const stat_timer&) = delete;
+	stat_timer& operator=(const stat_timer&) = delete;
+
+private:
+	stat_phase phase;
+	bool running;
+	std::chrono::steady_clock::time_point start;
+};
+
+// Peak resident set size of the process in bytes, 0 where unknown
+uint64_t peakMemory();
+
+// Writes the phases that ran, every counter and the peak memory, as text or
+// as one JSON object
+void printStats(std::ostream& out, bool json);
+
+#endif
@@ -0,0 +1,85 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#ifndef KREGRET_INCLUDE_THREAD_POOL_H_
+#define KREGRET_INCLUDE_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads that run chunked loops with work stealing.
+// run() deals the chunks of a loop out to per-worker deques in contiguous
+// runs; each worker takes chunks from the front of its own deque and, once
+// that is empty, steals from the back of the others, so uneven chunks even
+// out without a shared queue. The calling thread takes part as worker 0.
+//
+// One loop runs at a time. A loop started from inside a chunk (a nested
+// parallel stage) runs serially on the worker that started it.
+class thread_pool
+{
+public:
+	// Starts workers - 1 threads
+	explicit thread_pool(size_t workers);
+	~thread_pool();
+
+	size_t size() const { return workers; }
+
+	// Runs body(lo, hi, worker) on chunks of at most grain elements covering
+	// [begin, end) and returns when all of them are done. If a chunk throws,
+	// on any thread, the chunks not yet started are skipped and the first
+	// exception is rethrown here once the others have finished.
+	void run(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t, size_t)>& body);
+
+private:
+	struct job;
+	struct task
+	{
+		size_t lo, hi;
+		std::shared_ptr<job> owner;
+	};
+	struct task_queue
+	{
+		std::mutex lock;
+		std::deque<task> tasks;
+	};
+
+	bool next(size_t w, task& t);
+	void execute(size_t w, task& t);
+	void loop(size_t w);
+
+	size_t workers;
+	std::vector<std::unique_ptr<task_queue>> queues;
+	std::vector<std::thread> threads;
+
+	std::mutex wake;
+	std::condition_variable posted;
+	size_t generation;
+	bool stopping;
+
+	std::mutex serial; // held by run() for the whole loop
+};
+
+#endif
@@ -0,0 +1,52 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#ifndef KREGRET_INCLUDE_UTILITY_KERNELS_H_
+#define KREGRET_INCLUDE_UTILITY_KERNELS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <kregret/dataset.h>
+
+// Building blocks for scoring many points against many linear utilities.
+// Utilities are handled in blocks of kUtilityBlock, stored dimension-major
+// (w[j * width + u]) so that the innermost loops run over contiguous
+// utilities and vectorize. A block stays in cache while the points, packed
+// row-major, stream past it once.
+const size_t kUtilityBlock = 256;
+
+// Gathers the given rows of ds (all rows if rows is null) into a row-major
+// buffer, multiplying dimension j by scale[j]
+std::vector<double> packRows(const dataset& ds, const std::vector<size_t>* rows, size_t count, const double* scale);
+
+// Fills w with width utilities drawn uniformly from the non-negative part of
+// the unit sphere. Block b of a draw with a given seed is always the same,
+// whichever thread computes it.
+void sampleUtilities(uint64_t seed, size_t b, size_t D, size_t width, double* w);
+
+// best[u] = max over the packed points of p . w_u
+void blockMax(const double* points, size_t count, size_t D, const double* w, size_t width, double* best);
+
+// scores[i * width + u] = p_i . w_u for the packed points
+void blockScores(const double* points, size_t count, size_t D, const double* w, size_t width, double* scores);
+
+#endif
@@ -17,17 +17,39 @@
 //along with this program. If not, see <http://www.gnu.org/licenses/>.
 //==========================================================================================
 
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <limits>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <sstream>
 #include <string>
 #include <vector>
 
+#include <kregret/compact.h>
 #include <kregret/cube.h>
+#include <kregret/dataset.h>
 #include <kregret/point.h>
 #include <kregret/data_reader.h>
+#include <kregret/dataset_cache.h>
+#include <kregret/dynamic_cube.h>
+#include <kregret/greedy.h>
+#include <kregret/hitting_set.h>
+#include <kregret/parallel.h>
+#include <kregret/planar.h>
+#include <kregret/query_server.h>
+#include <kregret/regret.h>
+#include <kregret/shard.h>
+#include <kregret/size_list.h>
+#include <kregret/skyline.h>
+#include <kregret/sphere.h>
+#include <kregret/stats.h>
 
 void printHelp(const char* programName) {
 	std::string programFormatName = std::filesystem::path(programName).filename().string(); 
@@ -35,7 +57,10 @@ void printHelp(const char* programName) {
     std::cout << "    " << programFormatName << " - Run a k-regret algorithm on CSV data to find the representative subset\n\n";
     
     std::cout << "SYNOPSIS\n";
-    std::cout << "    " << programFormatName << " -f FILEPATH [-s SEPARATOR] [-k SIZE] [-h]\n\n";
+    std::cout << "    " << programFormatName << " -f FILEPATH [-s SEPARATOR] [-k SIZES] [-a ALGORITHM] [-e EVALUATOR]\n";
+    std::cout << "        [--search MODE] [--prefilter MODE] [--convert [OUTPUT]] [--no-cache] [--verify-cache] [-j N]\n";
+    std::cout << "        [--csv] [--updates FILE] [--precision MODE] [--shards M] [--stats[=json]] [-h]\n";
+    std::cout << "    " << programFormatName << " --serve [SOCKET] [--load NAME=PATH ...] [-f FILEPATH] [options]\n\n";
     
     std::cout << "DESCRIPTION\n";
     std::cout << "    This program reads a CSV file containing multi-dimensional data points and uses a\n";
@@ -52,10 +77,130 @@ void printHelp(const char* programName) {
     std::cout << "        Separator Character for the file provided\n";
     std::cout << "        Defaults to ',' if none provided.\n\n";
 
-    std::cout << "    -k SIZE\n";
+    std::cout << "    -k SIZES\n";
     std::cout << "        Size of the result set to select (optional, default: 20).\n";
-    std::cout << "        Must be a positive integer less than or equal to the total number of points.\n\n";
+    std::cout << "        Must be a positive integer less than or equal to the total number of points.\n";
+    std::cout << "        A range FIRST:LAST[:STEP] or a comma-separated list (e.g. 5:200:5 or 10,20,50)\n";
+    std::cout << "        runs a sweep: the file is loaded once, preprocessing is shared between\n";
+    std::cout << "        the sizes, and a table of k, regret ratio, time and indices is printed.\n\n";
     
+    std::cout << "    -a ALGORITHM\n";
+    std::cout << "        Selection algorithm (optional, default: cube).\n";
+    std::cout << "        cube    the cube \"strips\" algorithm; fast, but its regret bound grows\n";
+    std::cout << "                quickly with the number of dimensions. With two non-negative\n";
+    std::cout << "                columns it is replaced by an exact engine that returns an\n";
+    std::cout << "                optimal set.\n";
+    std::cout << "        greedy  repeatedly adds the point with the largest regret ratio (RDP-Greedy),\n";
+    std::cout << "                solving one warm-started linear program per skyline point per\n";
+    std::cout << "                round in parallel. Usually far lower regret for the same k.\n";
+    std::cout << "        sphere  covers sampled utility directions with their nearest points, found\n";
+    std::cout << "                with a kd-tree; meant for k in the hundreds or thousands.\n";
+    std::cout << "        hs      hitting set: finds the smallest regret eps for which k points reach\n";
+    std::cout << "                within eps of the best score on every sampled utility (uses\n";
+    std::cout << "                --samples and --seed); scales to very large inputs.\n\n";
+
+    std::cout << "    -e EVALUATOR\n";
+    std::cout << "        How the maximum regret ratio is measured (optional, default: axis).\n";
+    std::cout << "        axis     only the D axis-aligned utilities; a lower bound on the true ratio.\n";
+    std::cout << "        exact    every non-negative linear utility, by solving one small linear\n";
+    std::cout << "                 program per skyline point in parallel.\n";
+    std::cout << "        sampled  an estimate from random non-negative utilities, with a confidence\n";
+    std::cout << "                 statement (see --samples and --seed).\n\n";
+
+    std::cout << "    --samples M\n";
+    std::cout << "        Number of utilities drawn by the sampled evaluator (default: 100000) or,\n";
+    std::cout << "        if given, by the hs algorithm (default: max(2048, 16k)).\n\n";
+
+    std::cout << "    --seed S\n";
+    std::cout << "        Seed for the sampled evaluator and the hs algorithm (default: 1).\n\n";
+
+    std::cout << "    --search MODE\n";
+    std::cout << "        How the cube algorithm searches for its grid size (optional, default: linear).\n";
+    std::cout << "        linear  tries every grid size in turn, as in the original algorithm.\n";
+    std::cout << "        gallop  doubles the step and then bisects, using O(log t) passes; on data\n";
+    std::cout << "                where the point count is not monotone in the grid size it may\n";
+    std::cout << "                select a different set.\n\n";
+
+    std::cout << "    --prefilter MODE\n";
+    std::cout << "        Reduce the input before selection (optional, default: none).\n";
+    std::cout << "        skyline  keep only the Pareto-optimal points, computed on all cores. Every\n";
+    std::cout << "                 k-regret answer can be drawn from the skyline; the reduction\n";
+    std::cout << "                 ratio and the time spent are reported. A k as large as the\n";
+    std::cout << "                 skyline selects all of it, with a warning if k is larger.\n\n";
+
+    std::cout << "    --convert [OUTPUT]\n";
+    std::cout << "        Parse FILEPATH once and write it as a binary dataset cache, then exit.\n";
+    std::cout << "        Without OUTPUT the cache is written next to the input as FILEPATH.kbin.\n\n";
+
+    std::cout << "    --no-cache\n";
+    std::cout << "        Do not use FILEPATH.kbin even if it is up to date. By default the sidecar\n";
+    std::cout << "        cache is memory-mapped instead of parsing the text file whenever it is\n";
+    std::cout << "        at least as new as the input and was written with the same separator.\n";
+    std::cout << "        A cache file can also be passed directly with -f.\n\n";
+
+    std::cout << "    --verify-cache\n";
+    std::cout << "        Use the sidecar cache only if the input also hashes to the value recorded\n";
+    std::cout << "        when it was written. Catches an input replaced by one of the same size\n";
+    std::cout << "        with its modification time kept, at the cost of reading the whole input.\n\n";
+
+    std::cout << "    -j N\n";
+    std::cout << "        Number of worker threads (optional, default: one per hardware thread).\n";
+    std::cout << "        The result does not depend on N.\n\n";
+
+    std::cout << "    --csv\n";
+    std::cout << "        Print only the sweep table, as CSV: k,max_regret,time_ms,indices with the\n";
+    std::cout << "        indices separated by spaces.\n\n";
+
+    std::cout << "    --precision MODE\n";
+    std::cout << "        Storage of the working copy scanned by the cube algorithm and by the column\n";
+    std::cout << "        maxima of the axis evaluator (optional, default: double).\n";
+    std::cout << "        double   the input values themselves.\n";
+    std::cout << "        float32  4 bytes per value.\n";
+    std::cout << "        q16      2 bytes per value, spaced evenly between the column extremes.\n";
+    std::cout << "        Every decision the copy cannot settle within its error bound is made on\n";
+    std::cout << "        the doubles, so the selection and ratio do not change. With a binary cache\n";
+    std::cout << "        (see --convert) the doubles are then paged out and read back only where\n";
+    std::cout << "        needed. Other engines, the prefilter and the other evaluators use the doubles.\n\n";
+
+    std::cout << "    --shards M\n";
+    std::cout << "        With the cube algorithm, split the input into M slices of its rows, each\n";
+    std::cout << "        loaded and reduced by a worker process of its own, and run the selection\n";
+    std::cout << "        on what they report: the cube representatives of each slice for every grid\n";
+    std::cout << "        size tried and, for the exact and sampled evaluators, the slice skylines.\n";
+    std::cout << "        The selection and ratio are those of a single process. Takes a single k,\n";
+    std::cout << "        without --csv, a prefilter, --precision or --updates; -j is split among\n";
+    std::cout << "        the workers. POSIX systems only.\n\n";
+
+    std::cout << "    --stats[=json]\n";
+    std::cout << "        After the results, report the time spent in each phase (parse, cache_read,\n";
+    std::cout << "        convert, skyline, select, cube_pass, resolve, evaluate), the cube search\n";
+    std::cout << "        counters (grid sizes tried, cubes walked and occupied, points scanned,\n";
+    std::cout << "        duplicate points dropped) and the peak memory, as text or as one JSON\n";
+    std::cout << "        object. With --csv the report goes to stderr.\n\n";
+
+    std::cout << "    --serve [SOCKET]\n";
+    std::cout << "        Keep the datasets in memory and answer queries, one request per line, on a\n";
+    std::cout << "        Unix domain socket at SOCKET or, without it, on stdin/stdout. Requests:\n";
+    std::cout << "            load NAME PATH [SEP]\n";
+    std::cout << "            query NAME K [ENGINE [EVALUATOR]]\n";
+    std::cout << "            datasets | ping | quit | shutdown\n";
+    std::cout << "        Selections and ratios are cached per dataset, k, engine and evaluator.\n";
+    std::cout << "        -s, --search, --samples, --seed and -j apply to every query, -a and -e set\n";
+    std::cout << "        the engine and evaluator of a query that names none, and --no-cache and\n";
+    std::cout << "        --verify-cache apply to every load; --prefilter and --precision are not\n";
+    std::cout << "        available. A dataset given with -f is loaded as \"default\". k-regret-client\n";
+    std::cout << "        sends requests to a socket from the command line.\n\n";
+
+    std::cout << "    --updates FILE\n";
+    std::cout << "        With the cube algorithm, apply the insertions (\"+ v1,v2,...\", using the -s\n";
+    std::cout << "        separator) and deletions (\"- ID\") in FILE, one per line, keeping the\n";
+    std::cout << "        selection up to date after each, then report the final set. The input\n";
+    std::cout << "        rows have ids 0..N-1 and inserted points take the next ids. Only the\n";
+    std::cout << "        cube of an updated point is revisited unless it moves a column maximum.\n\n";
+
+    std::cout << "    --load NAME=PATH\n";
+    std::cout << "        With --serve, load PATH under NAME before serving (may be repeated).\n\n";
+
     std::cout << "    -h\n";
     std::cout << "        Display this help message and exit.\n\n";
     
@@ -65,6 +210,13 @@ void printHelp(const char* programName) {
     
     std::cout << "    " << programFormatName << " -f products.csv\n";
     std::cout << "        Process products.csv using default size of 20.\n\n";
+
+    std::cout << "    " << programFormatName << " -f products.csv -a greedy -k 5:200:5 --csv\n";
+    std::cout << "        Regret ratio against k for k = 5, 10, ..., 200 from one greedy run, as CSV.\n\n";
+
+    std::cout << "    " << programFormatName << " --serve /tmp/kregret.sock --load products=products.csv\n";
+    std::cout << "    k-regret-client /tmp/kregret.sock \"query products 20 greedy exact\"\n";
+    std::cout << "        Serve products.csv from memory and query it.\n\n";
     
     std::cout << "OUTPUT\n";
     std::cout << "    The program outputs:\n";
@@ -80,30 +232,18 @@ void printHelp(const char* programName) {
 	std::cout << std::flush;
 }
 
-double calculateMaxRegretRatio(size_t D, size_t N, int K, struct point* p, int* resultIndices) {
+double calculateMaxRegretRatio(const dataset& ds, const size_t* argmax, int K, const int* resultIndices) {
+    size_t D = ds.d;
     double maxRegret = 0.0;
 
     // Check axis-aligned utilities
-    for (int d = 0; d < D; d++) {
-        double* w = new double[D];
-        for (int j = 0; j < D; j++) {
-            w[j] = (j == d) ? 1.0 : 0.0;
-        }
-
-        // Find maximum utility among ALL points
-        double maxUtilityOverall = -std::numeric_limits<double>::infinity();
-        for (int i = 0; i < N; i++) {
-            double utility = dot(p[i], w);
-            if (utility > maxUtilityOverall) {
-                maxUtilityOverall = utility;
-            }
-        }
+    for (size_t d = 0; d < D; d++) {
+        double maxUtilityOverall = ds.value(argmax[d], d);
 
         // Find maximum utility in the result set
         double maxUtilityInSet = -std::numeric_limits<double>::infinity();
         for (int j = 0; j < K; j++) {
-            double utility = dot(p[resultIndices[j]], w);
-            maxUtilityInSet = std::max(maxUtilityInSet, utility);
+            maxUtilityInSet = std::max(maxUtilityInSet, ds.value(resultIndices[j], d));
         }
 
         // Calculate regret for this utility vector
@@ -111,13 +251,376 @@ double calculateMaxRegretRatio(size_t D, size_t N, int K, struct point* p, int*
             double regret = (maxUtilityOverall - maxUtilityInSet) / maxUtilityOverall;
             maxRegret = std::max(maxRegret, regret);
         }
-
-        delete[] w;
     }
 
     return maxRegret;
 }
 
+double calculateMaxRegretRatio(const dataset& ds, int K, int* resultIndices) {
+    // For an axis-aligned utility the best overall point is the column maximum
+    std::vector<size_t> argmax(ds.d);
+    columnArgMax(ds, argmax.data());
+    return calculateMaxRegretRatio(ds, argmax.data(), K, resultIndices);
+}
+
+// calculateMaxRegretRatio on the rows it reads, gathered through the compact
+// copy so that the doubles of a mapped cache are not faulted back in at once
+double calculateMaxRegretRatio(const compact_dataset& compact, const size_t* argmax, int K, const int* resultIndices) {
+    size_t D = compact.exact().d;
+    std::vector<size_t> rows(resultIndices, resultIndices + K);
+    rows.insert(rows.end(), argmax, argmax + D);
+    std::vector<size_t> top(D);
+    std::vector<int> selected(K);
+    for (size_t d = 0; d < D; d++) top[d] = K + d;
+    for (int j = 0; j < K; j++) selected[j] = j;
+    return calculateMaxRegretRatio(compact.exactRows(rows), top.data(), K, selected.data());
+}
+
+struct update_stats {
+    size_t inserts = 0;
+    size_t erases = 0;
+    size_t skipped = 0;
+    double totalUs = 0.0;
+    double maxUs = 0.0;
+};
+
+// Applies an update file to dyn: "+ v1,v2,...,vD" inserts a point (taking the
+// next id), "- ID" erases one; blank lines and lines starting with # are
+// ignored. Malformed lines are reported and skipped.
+void applyUpdates(const char* path, char sep, size_t D, dynamic_cube& dyn, update_stats& stats) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Error: Cannot open file " << path << std::endl;
+        exit(2);
+    }
+
+    std::string line;
+    std::vector<double> p(D);
+    for (size_t lineNumber = 1; std::getline(in, line); lineNumber++) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+        char op = line[first];
+        std::string rest = line.substr(first + 1);
+
+        auto start = std::chrono::steady_clock::now();
+        if (op == '+') {
+            size_t count = 0;
+            bool ok = true;
+            std::stringstream fields(rest);
+            std::string field;
+            while (ok && std::getline(fields, field, sep)) {
+                if (field.find_first_not_of(" \t\r") == std::string::npos) continue;
+                try {
+                    double value = std::stod(field);
+                    if (count < D) p[count] = value;
+                    count++;
+                } catch (const std::exception&) {
+                    ok = false;
+                }
+            }
+            if (!ok || count != D) {
+                std::cerr << "Warning: Line " << lineNumber << " of " << path << " needs " << D << " values. Skipping." << std::endl;
+                stats.skipped++;
+                continue;
+            }
+            start = std::chrono::steady_clock::now();
+            dyn.insert(p.data());
+            stats.inserts++;
+        }
+        else if (op == '-') {
+            size_t used = 0;
+            unsigned long long id = 0;
+            try {
+                id = std::stoull(rest, &used);
+            } catch (const std::exception&) {
+                used = 0;
+            }
+            if (used == 0 || rest.find_first_not_of(" \t\r", used) != std::string::npos) {
+                std::cerr << "Warning: Line " << lineNumber << " of " << path << " needs a point id. Skipping." << std::endl;
+                stats.skipped++;
+                continue;
+            }
+            start = std::chrono::steady_clock::now();
+            if (!dyn.erase((size_t)id)) {
+                std::cerr << "Warning: Line " << lineNumber << " of " << path << ": no live point with id " << id << ". Skipping." << std::endl;
+                stats.skipped++;
+                continue;
+            }
+            stats.erases++;
+        }
+        else {
+            std::cerr << "Warning: Line " << lineNumber << " of " << path << " must start with '+' or '-'. Skipping." << std::endl;
+            stats.skipped++;
+            continue;
+        }
+
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        stats.totalUs += us;
+        stats.maxUs = std::max(stats.maxUs, us);
+    }
+}
+
+// Everything that decides how a selection is made and scored
+struct run_settings {
+    std::string algorithm;
+    std::string evaluator;
+    cube_options options;
+    bool useSkyline;
+    size_t samples;
+    bool samplesGiven;
+    uint64_t seed;
+    bool csv;
+    const compact_dataset* compact; // working copy for the cube scans, or null
+};
+
+// The ratio of a selection made by --shards. The axis evaluator needs only
+// the column maxima; the skyline of the input, which the exact and sampled
+// evaluators reduce it to, is drawn from the union of the slice skylines.
+double shardedRegretRatio(shard_coordinator& shards, const std::string& evaluator, size_t K, const int* resultIndices,
+                          size_t samples, uint64_t seed, sampled_regret& estimate) {
+    size_t D = shards.dimensions();
+    std::vector<size_t> rows(resultIndices, resultIndices + K);
+    if (evaluator == "axis") {
+        // the selected rows come first, then the maxima
+        std::vector<size_t> argmax(D);
+        for (size_t j = 0; j < D; j++) {
+            argmax[j] = K + j;
+        }
+        std::vector<int> local(K);
+        for (size_t i = 0; i < K; i++) {
+            local[i] = (int)i;
+        }
+        rows.insert(rows.end(), shards.argmax().begin(), shards.argmax().end());
+        return calculateMaxRegretRatio(shards.points(rows), argmax.data(), (int)K, local.data());
+    }
+
+    dataset candidates;
+    std::vector<size_t> candidateRows;
+    std::string error;
+    if (!shards.skylines(candidates, candidateRows, error)) {
+        std::cerr << "Error: " << error << std::endl;
+        exit(2);
+    }
+    if (evaluator == "exact") {
+        return exactMaxRegretRatio(candidates, shards.points(rows));
+    }
+    estimate = sampledMaxRegretRatio(candidates, shards.points(rows), samples, seed);
+    return estimate.maxRegret;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Selects and scores a set for every size in sizes over one loaded dataset.
+// The prefilter, the column maxima, the evaluator's skyline and sampled best
+// scores, and the engine's own preprocessing are done once; cube passes are
+// shared between sizes and one greedy run serves every size. The time of a
+// size covers only the work done for it.
+int runSweep(const char* filename, const dataset& points, const std::vector<size_t>& sizes,
+             const run_settings& settings, const std::string& cacheUsed) {
+    size_t N = points.n, D = points.d;
+    size_t maxK = sizes.back();
+    const std::string& algorithm = settings.algorithm;
+    const std::string& evaluator = settings.evaluator;
+
+    if (!settings.csv) {
+        std::string title = algorithm == "hs" ? "Hitting Set" : algorithm;
+        title[0] = (char)toupper(title[0]);
+        std::cout << "\n=== " << title << " Algorithm Analysis ===" << std::endl;
+        std::cout << "Input file: " << filename << std::endl;
+        std::cout << "Dimensions: " << D << std::endl;
+        std::cout << "Target result set sizes: " << sizes.size() << " values from " << sizes.front()
+                  << " to " << maxK << std::endl;
+        if (!cacheUsed.empty()) {
+            std::cout << "Dataset cache: " << cacheUsed << std::endl;
+        }
+        if (settings.compact) {
+            std::cout << "Working copy: " << precisionName(settings.compact->mode()) << ", " << std::fixed
+                      << std::setprecision(1) << (settings.compact->bytes() / 1048576.0) << " MiB" << std::endl;
+        }
+        if (algorithm == "cube" && planarApplies(points)) {
+            std::cout << "Engine: exact two-dimensional" << std::endl;
+        }
+    }
+
+    auto shared = std::chrono::steady_clock::now();
+
+    // the skyline serves as the prefilter and as the evaluators' candidates
+    std::vector<size_t> sky;
+    dataset input = points;
+    if (settings.useSkyline || evaluator != "axis") {
+        sky = skyline(points);
+    }
+    if (settings.useSkyline) {
+        input = selectRows(points, sky);
+        if (!settings.csv) {
+            std::cout << "Skyline prefilter: kept " << sky.size() << " of " << N << " points ("
+                      << std::fixed << std::setprecision(2) << (100.0 * sky.size() / N) << "%)" << std::endl;
+        }
+        if (maxK > sky.size()) {
+            std::cerr << "Warning: sizes above " << sky.size() << " exceed the skyline; they select the whole skyline"
+                      << std::endl;
+        }
+    }
+    // sizes past the skyline are answered by all of it
+    size_t limit = std::min(maxK, input.n);
+
+    std::vector<size_t> argmax(D);
+    if (settings.compact) {
+        settings.compact->argmax(argmax.data());
+    }
+    else {
+        columnArgMax(points, argmax.data());
+    }
+    std::unique_ptr<regret_sampler> sampler;
+    if (evaluator == "sampled") {
+        stat_timer timer(stat_phase::evaluate);
+        sampler.reset(new regret_sampler(points, settings.samples, settings.seed, 0.95, &sky));
+    }
+
+    // engines that can answer every size from shared state
+    std::unique_ptr<cube_solver> cubes;
+    std::unique_ptr<planar_solver> plane;
+    std::vector<int> greedyIndices;
+    std::vector<double> greedyRegret(maxK + 1, 0.0), greedyTime(maxK + 1, 0.0);
+    if (algorithm == "cube" && planarApplies(points)) {
+        stat_timer timer(stat_phase::select);
+        plane.reset(new planar_solver(input));
+    }
+    else if (algorithm == "cube") {
+        stat_timer timer(stat_phase::select);
+        cubes.reset(new cube_solver(input, (int)limit, settings.options, settings.useSkyline ? nullptr : settings.compact));
+    }
+    double sharedMs = elapsedMs(shared);
+
+    if (algorithm == "greedy") {
+        // rounds past the last reported one added nothing: the regret is already 0
+        stat_timer timer(stat_phase::select);
+        auto start = std::chrono::steady_clock::now();
+        size_t rounds = 0;
+        greedyIndices.resize(limit);
+        greedy(input, (int)limit, greedyIndices.data(), [&](size_t round, double regret) {
+            greedyRegret[round] = regret;
+            greedyTime[round] = elapsedMs(start);
+            rounds = round;
+        });
+        for (size_t k = rounds + 1; k <= limit; k++) {
+            greedyTime[k] = elapsedMs(start);
+        }
+    }
+
+    struct row { size_t k; double regret; double ms; std::vector<int> indices; };
+    std::vector<row> table;
+    sampled_regret estimate = {};
+    double greedyDone = 0.0;
+    for (size_t asked : sizes) {
+        auto start = std::chrono::steady_clock::now();
+        size_t K = std::min(asked, input.n);
+        bool whole = settings.useSkyline && K == input.n;  // the whole skyline, which has ratio 0
+        std::vector<int> indices(K);
+        double selectMs = 0.0;
+        double exact = 0.0;  // the exact ratio, when the engine knows it
+
+        if (whole) {
+            for (size_t i = 0; i < K; i++) {
+                indices[i] = (int)i;
+            }
+        }
+        else {
+            stat_timer timer(stat_phase::select);
+            if (algorithm == "greedy") {
+                std::copy(greedyIndices.begin(), greedyIndices.begin() + K, indices.begin());
+                selectMs = greedyTime[K] - greedyDone;
+                greedyDone = greedyTime[K];
+            }
+            else if (algorithm == "sphere") {
+                sphere(input, (int)K, indices.data());
+            }
+            else if (algorithm == "hs") {
+                hittingSet(input, (int)K, indices.data(), settings.samplesGiven ? settings.samples : 0, settings.seed);
+            }
+            else if (plane) {
+                exact = plane->select((int)K, indices.data());
+            }
+            else {
+                cubes->select((int)K, indices.data());
+            }
+        }
+        if (settings.useSkyline) {
+            stat_timer timer(stat_phase::resolve);
+            for (size_t i = 0; i < K; i++) {
+                indices[i] = (int)sky[indices[i]];
+            }
+        }
+
+        double regret;
+        {
+            stat_timer timer(stat_phase::evaluate);
+            if (evaluator == "exact" && whole) {
+                regret = 0.0;
+            }
+            else if (evaluator == "exact" && algorithm == "greedy") {
+                regret = greedyRegret[K];
+            }
+            else if (evaluator == "exact" && plane) {
+                regret = exact;
+            }
+            else if (evaluator == "exact") {
+                std::vector<size_t> rows(indices.begin(), indices.end());
+                regret = exactMaxRegretRatio(points, selectRows(points, rows), &sky);
+            }
+            else if (evaluator == "sampled") {
+                std::vector<size_t> rows(indices.begin(), indices.end());
+                estimate = sampler->evaluate(selectRows(points, rows));
+                regret = estimate.maxRegret;
+            }
+            else if (settings.compact) {
+                regret = calculateMaxRegretRatio(*settings.compact, argmax.data(), (int)K, indices.data());
+            }
+            else {
+                regret = calculateMaxRegretRatio(points, argmax.data(), (int)K, indices.data());
+            }
+        }
+
+        table.push_back({ asked, regret, selectMs + elapsedMs(start), std::move(indices) });
+    }
+
+    if (settings.csv) {
+        std::cout << "k,max_regret,time_ms,indices" << std::endl;
+        for (const row& r : table) {
+            std::cout << r.k << "," << std::fixed << std::setprecision(6) << r.regret << ","
+                      << std::setprecision(3) << r.ms << ",";
+            for (size_t i = 0; i < r.indices.size(); i++) {
+                std::cout << (i ? " " : "") << r.indices[i];
+            }
+            std::cout << std::endl;
+        }
+        return 0;
+    }
+
+    std::cout << "\n=== Results ===" << std::endl;
+    std::cout << "Total points in dataset: " << N << std::endl;
+    std::cout << "Shared preprocessing: " << std::fixed << std::setprecision(3) << sharedMs << " ms" << std::endl;
+    if (evaluator == "sampled") {
+        std::cout << "Each ratio is estimated from " << estimate.samples << " sampled utilities: with "
+                  << std::setprecision(0) << (estimate.confidence * 100) << "% confidence, at most "
+                  << std::setprecision(4) << (estimate.tail * 100) << "% of utilities have a larger regret ratio" << std::endl;
+    }
+
+    std::cout << "\n" << std::setw(8) << "k" << std::setw(14) << "Max regret" << std::setw(12) << "Time (ms)"
+              << "   Selected point indices" << std::endl;
+    for (const row& r : table) {
+        std::cout << std::setw(8) << r.k << std::setw(14) << std::setprecision(6) << r.regret
+                  << std::setw(12) << std::setprecision(3) << r.ms << "   ";
+        for (size_t i = 0; i < r.indices.size(); i++) {
+            std::cout << (i ? ", " : "") << r.indices[i];
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+    return 0;
+}
 
 // Updated main function with command line parsing
 int main(int argc, char* argv[]) {
@@ -125,6 +628,27 @@ int main(int argc, char* argv[]) {
     char* filename = nullptr;
     char sep = ',';
     size_t K = 20;  // Result set size (default)
+    std::vector<size_t> sizes(1, K);
+    bool csv = false;
+    bool serve = false;
+    const char* socketPath = nullptr;  // serve on stdin/stdout without one
+    std::vector<std::string> loads;    // NAME=PATH pairs for --serve
+    const char* updatesPath = nullptr;
+    bool stats = false;
+    bool statsJson = false;
+    precision storage = precision::full;
+    cube_options options;
+    std::string algorithm = "cube";
+    bool useSkyline = false;
+    std::string evaluator = "axis";
+    size_t samples = 100000;
+    bool samplesGiven = false;
+    uint64_t seed = 1;
+    bool useCache = true;
+    bool verifyCache = false;  // hash the input before trusting its sidecar cache
+    const char* convertPath = nullptr;  // "" selects the sidecar path
+    size_t shardCount = 0;              // run the cube algorithm over this many worker processes
+    const char* shardWorker = nullptr;  // "I/M": serve slice I of M to a coordinator
     
     // Parse command line arguments
     for (int i = 1; i < argc; i++) {
@@ -146,7 +670,7 @@ int main(int argc, char* argv[]) {
                 try {
                     if (arg.size() == 1)
                     {
-                        sep = argv[++i][0];
+                        sep = arg[0];
                     }
                     else if (arg == "\\t") {
                         sep = '\t';
@@ -171,19 +695,188 @@ int main(int argc, char* argv[]) {
             }
         }
         else if (strcmp(argv[i], "-k") == 0) {
+            if (i + 1 < argc) {
+                std::string error;
+                if (!parseSizes(argv[++i], sizes, error)) {
+                    std::cerr << "Error: Invalid k value (" << error << ")\n";
+                    return 1;
+                }
+                K = sizes.back();
+            } else {
+                std::cerr << "Error: -k requires a numeric argument\n";
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--search") == 0) {
+            if (i + 1 < argc) {
+                std::string mode = argv[++i];
+                if (mode == "linear") {
+                    options.search = cube_search::linear;
+                }
+                else if (mode == "gallop") {
+                    options.search = cube_search::gallop;
+                }
+                else {
+                    std::cerr << "Error: Unknown search mode '" << mode << "' (expected linear or gallop)\n";
+                    return 1;
+                }
+            } else {
+                std::cerr << "Error: --search requires a mode argument\n";
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--prefilter") == 0) {
+            if (i + 1 < argc) {
+                std::string mode = argv[++i];
+                if (mode == "none") {
+                    useSkyline = false;
+                }
+                else if (mode == "skyline") {
+                    useSkyline = true;
+                }
+                else {
+                    std::cerr << "Error: Unknown prefilter '" << mode << "' (expected none or skyline)\n";
+                    return 1;
+                }
+            } else {
+                std::cerr << "Error: --prefilter requires a mode argument\n";
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-a") == 0) {
+            if (i + 1 < argc) {
+                algorithm = argv[++i];
+                if (algorithm != "cube" && algorithm != "greedy" && algorithm != "sphere" && algorithm != "hs") {
+                    std::cerr << "Error: Unknown algorithm '" << algorithm << "' (expected cube, greedy, sphere or hs)\n";
+                    return 1;
+                }
+            } else {
+                std::cerr << "Error: -a requires an algorithm argument\n";
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-e") == 0) {
+            if (i + 1 < argc) {
+                evaluator = argv[++i];
+                if (evaluator != "axis" && evaluator != "exact" && evaluator != "sampled") {
+                    std::cerr << "Error: Unknown evaluator '" << evaluator << "' (expected axis, exact or sampled)\n";
+                    return 1;
+                }
+            } else {
+                std::cerr << "Error: -e requires an evaluator argument\n";
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--samples") == 0 || strcmp(argv[i], "--seed") == 0) {
+            const char* option = argv[i];
             if (i + 1 < argc) {
                 try {
-                    K = std::stoi(argv[++i]);
-                    if (K <= 0) {
-                        std::cerr << "Error: Result set size must be positive\n";
+                    long long value = std::stoll(argv[++i]);
+                    if (value <= 0 && strcmp(option, "--samples") == 0) {
+                        std::cerr << "Error: Number of samples must be positive\n";
                         return 1;
                     }
+                    if (strcmp(option, "--samples") == 0) { samples = (size_t)value; samplesGiven = true; }
+                    else seed = (uint64_t)value;
                 } catch (const std::exception& e) {
-                    std::cerr << "Error: Invalid k value (" << e.what() << ")\n";
+                    std::cerr << "Error: Invalid " << option << " value (" << e.what() << ")\n";
                     return 1;
                 }
             } else {
-                std::cerr << "Error: -k requires a numeric argument\n";
+                std::cerr << "Error: " << option << " requires a numeric argument\n";
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--convert") == 0) {
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                convertPath = argv[++i];
+            } else {
+                convertPath = "";
+            }
+        }
+        else if (strcmp(argv[i], "-j") == 0) {
+            if (i + 1 < argc) {
+                try {
+                    int threads = std::stoi(argv[++i]);
+                    if (threads <= 0) {
+                        std::cerr << "Error: Number of threads must be positive\n";
+                        return 1;
+                    }
+                    setWorkerCount((size_t)threads);
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: Invalid thread count (" << e.what() << ")\n";
+                    return 1;
+                }
+            } else {
+                std::cerr << "Error: -j requires a numeric argument\n";
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--no-cache") == 0) {
+            useCache = false;
+        }
+        else if (strcmp(argv[i], "--verify-cache") == 0) {
+            verifyCache = true;
+        }
+        else if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        }
+        else if (strcmp(argv[i], "--precision") == 0) {
+            if (i + 1 < argc && parsePrecision(argv[i + 1], storage)) {
+                i++;
+            } else {
+                std::cerr << "Error: --precision requires double, float32 or q16\n";
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--stats") == 0 || strcmp(argv[i], "--stats=text") == 0) {
+            stats = true;
+        }
+        else if (strcmp(argv[i], "--stats=json") == 0) {
+            stats = true;
+            statsJson = true;
+        }
+        else if (strcmp(argv[i], "--serve") == 0) {
+            serve = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                socketPath = argv[++i];
+            }
+        }
+        else if (strcmp(argv[i], "--updates") == 0) {
+            if (i + 1 < argc) {
+                updatesPath = argv[++i];
+            } else {
+                std::cerr << "Error: --updates requires a filename argument\n";
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--shards") == 0) {
+            if (i + 1 < argc) {
+                try {
+                    int count = std::stoi(argv[++i]);
+                    if (count <= 0) {
+                        std::cerr << "Error: Number of shards must be positive\n";
+                        return 1;
+                    }
+                    shardCount = (size_t)count;
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: Invalid shard count (" << e.what() << ")\n";
+                    return 1;
+                }
+            } else {
+                std::cerr << "Error: --shards requires a numeric argument\n";
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--shard-worker") == 0 && i + 1 < argc) {
+            // started by --shards, not meant to be run by hand
+            shardWorker = argv[++i];
+        }
+        else if (strcmp(argv[i], "--load") == 0) {
+            if (i + 1 < argc && strchr(argv[i + 1], '=') != nullptr && argv[i + 1][0] != '=') {
+                loads.push_back(argv[++i]);
+            } else {
+                std::cerr << "Error: --load requires a NAME=PATH argument\n";
                 return 1;
             }
         }
@@ -194,6 +887,81 @@ int main(int argc, char* argv[]) {
         }
     }
     
+    if (shardWorker != nullptr) {
+        // Speak the binary protocol of shard.h on stdin/stdout
+        size_t slice = 0, slices = 0;
+        char slash = 0;
+        std::istringstream spec(shardWorker);
+        if (filename == nullptr || !(spec >> slice >> slash >> slices) || slash != '/' || slice >= slices) {
+            std::cerr << "Error: --shard-worker requires I/M and -f\n";
+            return 1;
+        }
+        dataset slicePoints;
+        read_status status = loadShard(filename, sep, slice, slices, useCache, slicePoints);
+        serveShard(status, slicePoints, stdin, stdout);
+        return 0;
+    }
+
+    if (stats && serve) {
+        std::cerr << "Error: --stats is not available with --serve\n";
+        return 1;
+    }
+    if (serve && (useSkyline || storage != precision::full)) {
+        std::cerr << "Error: --prefilter and --precision are not available with --serve\n";
+        return 1;
+    }
+    if (stats) {
+        enableStats();
+    }
+
+    if (serve) {
+        server_settings settings;
+        settings.engine = algorithm;
+        settings.evaluator = evaluator;
+        settings.options = options;
+        settings.samples = samples;
+        settings.hsDirections = samplesGiven ? samples : 0;
+        settings.seed = seed;
+        settings.useCache = useCache;
+        settings.verifyCache = verifyCache;
+        query_server server(settings);
+
+        if (filename != nullptr) {
+            loads.insert(loads.begin(), std::string("default=") + filename);
+        }
+        for (const std::string& entry : loads) {
+            size_t eq = entry.find('=');
+            std::string error;
+            if (!server.load(entry.substr(0, eq), entry.substr(eq + 1), sep, error)) {
+                std::cerr << "Error: " << error << std::endl;
+                exit(2);
+            }
+        }
+
+        if (socketPath == nullptr) {
+            server.serveStream(std::cin, std::cout);
+            return 0;
+        }
+        std::cerr << "Serving " << loads.size() << " dataset(s) on " << socketPath << std::endl;
+        std::string error;
+        if (!server.serveSocket(socketPath, error)) {
+            std::cerr << "Error: " << error << std::endl;
+            return 2;
+        }
+        return 0;
+    }
+
+    if (updatesPath != nullptr && (algorithm != "cube" || useSkyline || sizes.size() > 1 || csv || storage != precision::full)) {
+        std::cerr << "Error: --updates works with the cube algorithm and a single k, without a prefilter or --precision\n";
+        return 1;
+    }
+
+    if (shardCount > 0 && (serve || algorithm != "cube" || useSkyline || sizes.size() > 1 || csv
+                           || storage != precision::full || updatesPath != nullptr || convertPath != nullptr)) {
+        std::cerr << "Error: --shards works with the cube algorithm and a single k, without a prefilter, --csv, --precision, --updates or --convert\n";
+        return 1;
+    }
+
     // Validate required arguments
     if (filename == nullptr) {
         std::cerr << "Error: Filename is required. Use -f to specify the input file.\n";
@@ -201,10 +969,61 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
-    // Process the file
+    // Process the file, preferring a binary cache when one is usable
     size_t N;  // Total number of points
     size_t D; // Dimensions    
-	std::vector<std::vector<double>> data = processData(filename, sep, D, N);
+    dataset points;
+    std::string cacheUsed;
+    shard_coordinator shards;
+    if (shardCount > 0) {
+        // The points stay with the workers; only what the selection needs comes back.
+        // They check a sidecar cache by time and size alone, so it is verified here
+        std::string error;
+        if (verifyCache && useCache && !isDatasetCache(filename) && !cacheIsFresh(filename, sep, true)) {
+            useCache = false;
+        }
+        if (!shards.start(argv[0], filename, sep, shardCount, std::max<size_t>(1, workerCount() / shardCount),
+                          useCache, error)) {
+            std::cerr << "Error: " << error << std::endl;
+            exit(2);
+        }
+        if (shards.size() == 0) {
+            std::cerr << "Error: No valid data found in file" << std::endl;
+            exit(3);
+        }
+        // the workers map a cache on the same terms as loadShard() states them
+        if (isDatasetCache(filename)) {
+            cacheUsed = filename;
+        }
+        else if (useCache && cacheIsFresh(filename, sep)) {
+            cacheUsed = cachePath(filename);
+        }
+    }
+    else if (isDatasetCache(filename) && readDatasetCache(filename, points)) {
+        cacheUsed = filename;
+    }
+    else if (useCache && convertPath == nullptr && cacheIsFresh(filename, sep, verifyCache)
+             && readDatasetCache(cachePath(filename).c_str(), points)) {
+        cacheUsed = cachePath(filename);
+    }
+    else {
+        points = readDataset(filename, sep);
+    }
+    D = shardCount > 0 ? shards.dimensions() : points.d;
+    N = shardCount > 0 ? shards.size() : points.n;
+
+    if (convertPath != nullptr) {
+        std::string out = *convertPath ? convertPath : cachePath(filename);
+        if (!writeDatasetCache(out.c_str(), points, filename, sep)) {
+            std::cerr << "Error: Cannot write dataset cache " << out << std::endl;
+            exit(2);
+        }
+        std::cout << "Wrote " << N << " points in " << D << " dimensions to " << out << std::endl;
+        if (stats) {
+            printStats(std::cout, statsJson);
+        }
+        return 0;
+    }
     
     if (K > N) {
         std::cerr << "Error: Result set size (k=" << K << ") cannot be larger than number of points (n=" << N << ")" << std::endl;
@@ -217,27 +1036,193 @@ int main(int argc, char* argv[]) {
         exit(3);
     }
 
-	std::cout << "\n=== Cube Algorithm Analysis ===" << std::endl;
+    // The reduced copy replaces the doubles in the scans; pages of a mapped
+    // cache are dropped and come back only for the rows the copy cannot settle
+    std::unique_ptr<compact_dataset> compact;
+    if (storage != precision::full) {
+        stat_timer timer(stat_phase::convert);
+        compact.reset(new compact_dataset(points, storage, !cacheUsed.empty()));
+    }
+
+    if (sizes.size() > 1 || csv) {
+        run_settings settings = { algorithm, evaluator, options, useSkyline, samples, samplesGiven, seed, csv, compact.get() };
+        int status = runSweep(filename, points, sizes, settings, cacheUsed);
+        if (stats) {
+            // keep the CSV on stdout parseable
+            printStats(csv ? std::cerr : std::cout, statsJson);
+        }
+        return status;
+    }
+
+    std::string title = algorithm == "hs" ? "Hitting Set" : algorithm;
+    title[0] = (char)toupper(title[0]);
+    std::cout << "\n=== " << title << " Algorithm Analysis ===" << std::endl;
     std::cout << "Input file: " << filename << std::endl;
     std::cout << "Dimensions: " << D << std::endl;
     std::cout << "Target result set size: " << K << std::endl;
-
-    point* points = pointArray(data, D, N);
+    if (!cacheUsed.empty()) {
+        std::cout << "Dataset cache: " << cacheUsed << std::endl;
+    }
+    if (shardCount > 0) {
+        std::cout << "Shards: " << shardCount << std::endl;
+    }
+    if (compact) {
+        std::cout << "Working copy: " << precisionName(storage) << ", " << std::fixed << std::setprecision(1)
+                  << (compact->bytes() / 1048576.0) << " MiB" << std::endl;
+    }
+    // two columns have an exact engine; updates and shards stay with the cube algorithm
+    bool planarEngine = algorithm == "cube" && updatesPath == nullptr && shardCount == 0 && planarApplies(points);
+    if (planarEngine) {
+        std::cout << "Engine: exact two-dimensional" << std::endl;
+    }
 
     // Allocate memory for result indices
     int* resultIndices = new int[K];
+    kregret_result selection;
+    std::vector<size_t> liveIds;  // point ids of the rows of points after --updates
     
-    // Run cube algorithm
-    cube(D, N, K, points, resultIndices);
+    if (updatesPath != nullptr) {
+        // Keep the cube answer current while the updates are applied, then score
+        // it on the points that are left
+        auto start = std::chrono::steady_clock::now();
+        dynamic_cube dyn = [&]() {
+            stat_timer timer(stat_phase::select);
+            return dynamic_cube(points, (int)K, options);
+        }();
+        double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        update_stats stats;
+        applyUpdates(updatesPath, sep, D, dyn, stats);
+        size_t applied = stats.inserts + stats.erases;
+
+        std::cout << "Initial selection: " << std::fixed << std::setprecision(3) << buildMs << " ms" << std::endl;
+        std::cout << "Updates: " << stats.inserts << " inserts, " << stats.erases << " deletes";
+        if (stats.skipped) std::cout << ", " << stats.skipped << " skipped";
+        std::cout << " in " << std::setprecision(3) << (stats.totalUs / 1000) << " ms (mean "
+                  << std::setprecision(2) << (applied ? stats.totalUs / applied : 0.0) << " us, max "
+                  << stats.maxUs << " us), " << dyn.rebuilds() << " rebuilds" << std::endl;
+
+        points = dyn.livePoints(&liveIds);
+        N = points.n;
+        if (K > N) {
+            std::cerr << "Error: Result set size (k=" << K << ") cannot be larger than number of points (n=" << N << ")" << std::endl;
+            exit(3);
+        }
+        stat_timer timer(stat_phase::resolve);
+        for (size_t i = 0; i < K; i++) {
+            resultIndices[i] = (int)(std::lower_bound(liveIds.begin(), liveIds.end(), dyn.selected()[i]) - liveIds.begin());
+        }
+    }
+    else if (shardCount > 0) {
+        stat_timer timer(stat_phase::select);
+        std::vector<size_t> rows;
+        std::string error;
+        if (!shards.cube((int)K, options, rows, error)) {
+            std::cerr << "Error: " << error << std::endl;
+            exit(2);
+        }
+        std::copy(rows.begin(), rows.end(), resultIndices);
+    }
+    else if (useSkyline) {
+        // Run cube algorithm on the skyline and map the answer back to original rows
+        auto start = std::chrono::steady_clock::now();
+        std::vector<size_t> rows = skyline(points);
+        dataset reduced = selectRows(points, rows);
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "Skyline prefilter: kept " << rows.size() << " of " << N << " points ("
+                  << std::fixed << std::setprecision(2) << (100.0 * rows.size() / N) << "%) in "
+                  << std::setprecision(3) << elapsed << " ms" << std::endl;
+
+        if (K >= rows.size()) {
+            // the whole skyline has ratio 0, and the engines would only repeat its points
+            if (K > rows.size()) {
+                std::cerr << "Warning: k=" << K << " exceeds the " << rows.size()
+                          << " skyline points; selecting the whole skyline" << std::endl;
+            }
+            K = rows.size();
+            for (size_t i = 0; i < K; i++) {
+                resultIndices[i] = (int)i;
+            }
+        }
+        else {
+            stat_timer timer(stat_phase::select);
+            if (algorithm == "greedy") {
+                selection = greedy(reduced, K, resultIndices);
+            }
+            else if (algorithm == "sphere") {
+                selection = sphere(reduced, K, resultIndices);
+            }
+            else if (algorithm == "hs") {
+                selection = hittingSet(reduced, K, resultIndices, samplesGiven ? samples : 0, seed);
+            }
+            else if (planarEngine) {
+                selection = planar(reduced, K, resultIndices);
+            }
+            else {
+                cube(reduced, K, resultIndices, options);
+            }
+        }
+        stat_timer timer(stat_phase::resolve);
+        for (size_t i = 0; i < K; i++) {
+            resultIndices[i] = (int)rows[resultIndices[i]];
+        }
+    }
+    else {
+        // Run the selection algorithm
+        stat_timer timer(stat_phase::select);
+        if (algorithm == "greedy") {
+            selection = greedy(points, K, resultIndices);
+        }
+        else if (algorithm == "sphere") {
+            selection = sphere(points, K, resultIndices);
+        }
+        else if (algorithm == "hs") {
+            selection = hittingSet(points, K, resultIndices, samplesGiven ? samples : 0, seed);
+        }
+        else if (planarEngine) {
+            selection = planar(points, K, resultIndices);
+        }
+        else {
+            cube(points, K, resultIndices, options, compact.get());
+        }
+    }
     
     // Calculate max regret ratio
-    double maxRegretRatio = calculateMaxRegretRatio(D, N, K, points, resultIndices);
-    
-    // Clean up
-    for (int i = 0; i < N; i++) {
-        delete[] points[i].a;
+    double maxRegretRatio;
+    sampled_regret estimate = {};
+    {
+        stat_timer timer(stat_phase::evaluate);
+        if (shardCount > 0) {
+            maxRegretRatio = shardedRegretRatio(shards, evaluator, K, resultIndices, samples, seed, estimate);
+        }
+        else if (evaluator == "exact" && (algorithm == "greedy" || planarEngine)) {
+            // greedy and the two-dimensional engine already know the exact ratio of
+            // their set; the skyline prefilter keeps every column maximum, so it is
+            // the same on the reduced input
+            maxRegretRatio = selection.max_regret;
+        }
+        else if (evaluator == "exact") {
+            std::vector<size_t> rows(resultIndices, resultIndices + K);
+            maxRegretRatio = exactMaxRegretRatio(points, selectRows(points, rows));
+        }
+        else if (evaluator == "sampled") {
+            std::vector<size_t> rows(resultIndices, resultIndices + K);
+            estimate = sampledMaxRegretRatio(points, selectRows(points, rows), samples, seed);
+            maxRegretRatio = estimate.maxRegret;
+        }
+        else {
+            std::vector<size_t> argmax(D);
+            if (compact) {
+                compact->argmax(argmax.data());
+                maxRegretRatio = calculateMaxRegretRatio(*compact, argmax.data(), K, resultIndices);
+            }
+            else {
+                columnArgMax(points, argmax.data());
+                maxRegretRatio = calculateMaxRegretRatio(points, argmax.data(), K, resultIndices);
+            }
+        }
     }
-    delete[] points;
 	
 	
     // Output results
@@ -246,10 +1231,15 @@ int main(int argc, char* argv[]) {
     std::cout << "Points selected: " << K << std::endl;
     std::cout << "Maximum Regret Ratio: " << std::fixed << std::setprecision(6) << maxRegretRatio << std::endl;
     std::cout << "Regret percentage: " << std::fixed << std::setprecision(2) << (maxRegretRatio * 100) << "%" << std::endl;
+    if (evaluator == "sampled") {
+        std::cout << "Estimated from " << estimate.samples << " sampled utilities: with "
+                  << std::setprecision(0) << (estimate.confidence * 100) << "% confidence, at most "
+                  << std::setprecision(4) << (estimate.tail * 100) << "% of utilities have a larger regret ratio" << std::endl;
+    }
     
     std::cout << "\nSelected point indices: ";
     for (int i = 0; i < K; i++) {
-        std::cout << resultIndices[i];
+        std::cout << (liveIds.empty() ? (size_t)resultIndices[i] : liveIds[resultIndices[i]]);
         if (i < K - 1) std::cout << ", ";
     }
     std::cout << std::endl;
@@ -257,6 +1247,10 @@ int main(int argc, char* argv[]) {
     std::cout << "\nInterpretation: In the worst case, a user would get " 
               << std::fixed << std::setprecision(5) << ((1 - maxRegretRatio) * 100) 
               << "% of their maximum possible utility when choosing from the selected subset.\n" << std::endl;
+
+    if (stats) {
+        printStats(std::cout, statsJson);
+    }
     
     delete[] resultIndices;
     
@@ -0,0 +1,253 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+// Reduced-precision working copies with error bounds
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+
+#include <kregret/compact.h>
+#include <kregret/dataset_cache.h>
+#include <kregret/dataset_stats.h>
+#include <kregret/parallel.h>
+
+// Rows per chunk when scanning, and per block between page releases when
+// encoding (a serial parallelFor hands its body the whole range)
+static const size_t kCompactGrain = 1 << 16;
+
+bool parsePrecision(const std::string& name, precision& out)
+{
+	if (name == "double")
+		out = precision::full;
+	else if (name == "float32")
+		out = precision::float32;
+	else if (name == "q16")
+		out = precision::quantized16;
+	else
+		return false;
+	return true;
+}
+
+const char* precisionName(precision p)
+{
+	switch (p)
+	{
+	case precision::float32:
+		return "float32";
+	case precision::quantized16:
+		return "q16";
+	default:
+		return "double";
+	}
+}
+
+compact_dataset::compact_dataset(const dataset& data, precision p, bool mappedCache)
+	: ds(data), kind(p == precision::float32 ? precision::float32 : precision::quantized16), mapped(mappedCache),
+	  offset(data.d, 0.0), step(data.d, 1.0), bound(data.d, 0.0), low(data.d, std::numeric_limits<double>::infinity()),
+	  high(data.d, -std::numeric_limits<double>::infinity()), zero(data.d, -1), reads(0)
+{
+	size_t D = ds.d, N = ds.n;
+	const double inf = std::numeric_limits<double>::infinity();
+
+	// Column extremes over the finite values and whether every value is finite,
+	// reduced per worker. A float32 copy is encoded in the same pass; a
+	// quantized one needs the extremes first.
+	std::vector<char> finite(D, 1);
+	std::vector<std::vector<double>> partial(workerCount());
+	for (auto& local : partial)
+		for (size_t j = 0; j < D; ++j)
+			local.insert(local.end(), { inf, -inf, 1.0 });
+
+	if (kind == precision::float32)
+		floats.resize(D * N);
+	else
+		words.resize(D * N);
+
+	parallelFor(0, N, kCompactGrain, [&](size_t first, size_t last, size_t w) {
+		std::vector<double>& local = partial[w];
+		for (size_t block = first; block < last; block += kCompactGrain)
+		{
+			size_t end = std::min(last, block + kCompactGrain);
+			for (size_t j = 0; j < D; ++j)
+				for (size_t i = block; i < end; ++i)
+				{
+					double v = ds.value(i, j);
+					if (kind == precision::float32)
+						floats[j * N + i] = (float)v;
+					if (std::isfinite(v))
+					{
+						local[3 * j] = std::min(local[3 * j], v);
+						local[3 * j + 1] = std::max(local[3 * j + 1], v);
+					}
+					else
+						local[3 * j + 2] = 0;
+				}
+			if (mapped)
+				releaseDatasetCache(ds, block, end);
+		}
+	});
+	for (const auto& local : partial)
+		for (size_t j = 0; j < D; ++j)
+		{
+			low[j] = std::min(low[j], local[3 * j]);
+			high[j] = std::max(high[j], local[3 * j + 1]);
+			finite[j] &= local[3 * j + 2] != 0;
+		}
+
+	// The bounds cover the rounding of the encoding itself plus a few ulps of
+	// slack for the arithmetic around it
+	for (size_t j = 0; j < D; ++j)
+	{
+		double magnitude = std::max(std::fabs(low[j]), std::fabs(high[j]));
+		if (!finite[j] || !(magnitude <= FLT_MAX))
+		{
+			bound[j] = inf;
+			low[j] = -inf;
+			high[j] = inf;
+			continue;
+		}
+		if (kind == precision::float32)
+			bound[j] = magnitude * (0x1p-24 + 0x1p-44) + 0x1p-149;
+		else
+		{
+			// One code is kept spare so that, when the column spans 0, the grid
+			// can be shifted to put 0 on code zero[j] and still cover [low, high]
+			offset[j] = low[j];
+			step[j] = (high[j] - low[j]) / 65534.0;
+			bound[j] = step[j] * (0.5 + 0x1p-20) + magnitude * 0x1p-44;
+			double code = step[j] > 0 ? std::ceil(-low[j] / step[j]) : -1;
+			if (low[j] <= 0 && high[j] >= 0 && code >= 0 && code <= 65534)
+			{
+				zero[j] = (long)code;
+				offset[j] = -(step[j] * zero[j]);
+			}
+		}
+	}
+
+	if (kind == precision::float32)
+		return;
+
+	parallelFor(0, N, kCompactGrain, [&](size_t first, size_t last, size_t) {
+		for (size_t block = first; block < last; block += kCompactGrain)
+		{
+			size_t end = std::min(last, block + kCompactGrain);
+			for (size_t j = 0; j < D; ++j)
+				for (size_t i = block; i < end; ++i)
+				{
+					double v = ds.value(i, j);
+					long code = 0;
+					if (step[j] > 0 && std::isfinite(v))
+						code = (long)std::min(65535.0, std::max(0.0, std::nearbyint((v - offset[j]) / step[j])));
+					// only 0 itself gets the code of 0, so that its sign is never in doubt;
+					// the values next to it move one code out
+					if (zero[j] >= 0 && v != 0 && code == zero[j])
+						code += v > 0 ? 1 : -1;
+					words[j * N + i] = (uint16_t)code;
+				}
+			if (mapped)
+				releaseDatasetCache(ds, block, end);
+		}
+	});
+}
+
+bool compact_dataset::bounded() const
+{
+	for (size_t j = 0; j < ds.d; ++j)
+		if (std::isinf(bound[j]))
+			return false;
+	return true;
+}
+
+void compact_dataset::argmax(size_t* out) const
+{
+// The maximum is at least the largest lower end of a range, so only rows
+// whose range reaches it can attain it; those are gathered on the copy and
+// compared on the doubles, with the tie-break of columnArgMax (lowest row
+// among equal values). A summary of the doubles makes it a lookup.
+	size_t D = ds.d, N = ds.n;
+	if (!bounded() || (ds.stats && ds.stats->covers(ds)))
+	{
+		columnArgMax(ds, out);
+		return;
+	}
+
+	visit([&](auto view) {
+		std::vector<double> threshold(D, -std::numeric_limits<double>::infinity());
+		std::vector<std::vector<double>> partial(workerCount(), threshold);
+		parallelFor(0, N, kCompactGrain, [&](size_t first, size_t last, size_t w) {
+			double lo, hi;
+			for (size_t j = 0; j < D; ++j)
+				for (size_t i = first; i < last; ++i)
+				{
+					view.range(i, j, lo, hi);
+					partial[w][j] = std::max(partial[w][j], lo);
+				}
+		});
+		for (const auto& local : partial)
+			for (size_t j = 0; j < D; ++j)
+				threshold[j] = std::max(threshold[j], local[j]);
+
+		std::vector<std::vector<std::vector<size_t>>> near(workerCount(), std::vector<std::vector<size_t>>(D));
+		parallelFor(0, N, kCompactGrain, [&](size_t first, size_t last, size_t w) {
+			double lo, hi;
+			for (size_t j = 0; j < D; ++j)
+				for (size_t i = first; i < last; ++i)
+				{
+					view.range(i, j, lo, hi);
+					if (hi >= threshold[j])
+						near[w][j].push_back(i);
+				}
+		});
+
+		for (size_t j = 0; j < D; ++j)
+		{
+			double best = -std::numeric_limits<double>::infinity();
+			out[j] = (size_t)-1;
+			for (const auto& local : near)
+				for (size_t i : local[j])
+				{
+					double v = exactValue(i, j);
+					if (out[j] == (size_t)-1 || v > best || (v == best && i < out[j]))
+					{
+						out[j] = i;
+						best = v;
+					}
+				}
+		}
+	});
+	releaseExact();
+}
+
+dataset compact_dataset::exactRows(const std::vector<size_t>& rows) const
+{
+	dataset out = allocateDataset(ds.d, rows.size());
+	for (size_t i = 0; i < rows.size(); ++i)
+		for (size_t j = 0; j < ds.d; ++j)
+			out.value(i, j) = exactValue(rows[i], j);
+	releaseExact();
+	return out;
+}
+
+void compact_dataset::releaseExact() const
+{
+	if (mapped)
+		releaseDatasetCache(ds);
+}
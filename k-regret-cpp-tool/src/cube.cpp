@@ -18,117 +18,723 @@
 //==========================================================================================
 
 // Algorithm using the cube "strips" method
-#include <vector>
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
 
+#include <kregret/compact.h>
 #include <kregret/cube.h>
+#include <kregret/kernels.h>
+#include <kregret/parallel.h>
+#include <kregret/stats.h>
+
+// Candidates per chunk when bucketing points into cubes
+static const size_t kBucketGrain = 1 << 14;
 
-int cubealgorithm(size_t D, size_t N, int K, struct point *p, size_t L, int t, struct point *c, struct point *answer)
+long cubeCell(double v, double c, int t)
 {
-	size_t i, j, index, inCube, seenBefore;
-	bool done;
-	int cubeBestIndex;
+// Finds the strip b with b*c <= v < (b+1)*c and 0 <= b < t, using the same
+// floating-point comparisons as the cube test. Returns -1 if there is none.
+	long b;
 
-	std::vector<int>boundary(D,0);
+	if (!(c > 0) || !(v >= 0))
+		return -1;
 
-	index = 0;
-	// first list the maximal points in the directions {1,...,D}\L
-	for(i = 0; i < D; ++i)
-		if (i != L)
-			answer[index++] = c[i];
+	b = (long)std::floor(v / c);
+	if (b < 0) b = 0;
+	if (b > t - 1) b = t - 1;
+	while (b > 0 && b * c > v)
+		b--;
+	while (b < t - 1 && (b + 1) * c <= v)
+		b++;
 
-	/*** Try all 0 <= j_1, j_2, \ldots < t ***/
-	done = false;
-	while(!done && index < K)
+	if (b * c <= v && v < (b + 1) * c)
+		return b;
+	return -1;
+}
+
+size_t coordinate_hash::operator()(size_t i) const
+{
+	uint64_t h = 14695981039346656037ULL;
+	for(size_t j = 0; j < ds->d; ++j)
 	{
-		// pick the maximal point in current cube
-		cubeBestIndex = -1;
-		for(i = 0; i < N; ++i)
+		double v = compact ? compact->value(i, j) : ds->value(i, j);
+		uint64_t bits;
+		if (v == 0)
+			v = 0; // -0.0 and 0.0 compare equal
+		std::memcpy(&bits, &v, sizeof(bits));
+		h = (h ^ bits) * 1099511628211ULL;
+	}
+	return (size_t)h;
+}
+
+bool coordinate_equal::operator()(size_t a, size_t b) const
+{
+	if (compact)
+		for(size_t j = 0; j < ds->d; ++j)
+			if (compact->value(a, j) < compact->value(b, j) || compact->value(a, j) > compact->value(b, j))
+				return false;
+	auto value = [&](size_t i, size_t j) { return compact ? compact->exactValue(i, j) : ds->value(i, j); };
+	for(size_t j = 0; j < ds->d; ++j)
+		if (value(a, j) < value(b, j) || value(a, j) > value(b, j))
+			return false;
+	return true;
+}
+
+void distinct_rows::reset(const dataset& ds, const compact_dataset* compact)
+{
+	hash = coordinate_hash{&ds, compact};
+	equal = coordinate_equal{&ds, compact};
+	count = 0;
+	std::fill(slots.begin(), slots.end(), 0);
+}
+
+bool distinct_rows::insert(size_t row)
+{
+	if (2 * (count + 1) > slots.size())
+		grow();
+	size_t h = home(row);
+	for (; slots[h] != 0; h = (h + 1) & (slots.size() - 1))
+		if (equal(slots[h] - 1, row))
+			return false;
+	slots[h] = row + 1;
+	count++;
+	return true;
+}
+
+void distinct_rows::grow()
+{
+	std::vector<size_t> old((size_t)1 << std::max(bits + 1, 4), 0);
+	old.swap(slots);
+	bits = std::max(bits + 1, 4);
+	for (size_t i = 0; i < old.size(); ++i)
+		if (old[i] != 0)
 		{
-			// determine if p[i] is in this cube
-			inCube = 1;
-			for(j = 0; j < D && inCube; ++j)
-				if (j != L)  // not the excluded dimension
-					inCube = (boundary[j] * c[j].a[j] <= t * p[i].a[j]) && (t * p[i].a[j] < (boundary[j] + 1) * c[j].a[j]);
-
-			if (inCube)  // check if it is maximal in the missing dimension
-				if (cubeBestIndex < 0)
-					cubeBestIndex = i;  // none seen yet, set to i
-				else if(p[i].a[L] > p[cubeBestIndex].a[L])
-						cubeBestIndex = i; // replace if larger in dimension L
+			size_t h = home(old[i] - 1);
+			while (slots[h] != 0)
+				h = (h + 1) & (slots.size() - 1);
+			slots[h] = old[i];
 		}
+}
+
+bool atMostDistinct(const dataset& ds, const size_t* rows, size_t count, size_t limit, const compact_dataset* compact,
+	cube_scratch* scratch)
+{
+	if (count <= limit)
+		return true;
+	distinct_rows own;
+	distinct_rows& seen = scratch ? scratch->seen : own;
+	seen.reset(ds, compact);
+	for(size_t i = 0; i < count; ++i)
+		if (seen.insert(rows[i]) && seen.size() > limit)
+			return false;
+	return true;
+}
+
+// cells.cell() result for a coordinate the compact copy cannot place
+static const long kUndecided = -2;
+
+// Cube tests on the doubles. The representative of a cube is the point that
+// is larger in dimension L, or equal with a lower row: the point a serial
+// scan in row order keeps, whatever order the points arrive in. An entry
+// holds the representative so far.
+struct exact_cells
+{
+	typedef size_t entry;
+
+	const dataset& ds;
+	size_t L;
+
+	double exactValue(size_t i, size_t j) const { return ds.value(i, j); }
+	long cell(size_t i, size_t j, double c, int t) const { return cubeCell(t * ds.value(i, j), c, t); }
+	long exactCell(size_t i, size_t j, double c, int t) const { return cell(i, j, c, t); }
+
+	entry start(size_t i) const { return i; }
+
+	void add(entry& e, size_t i) const
+	{
+		double vi = ds.value(i, L), ve = ds.value(e, L);
+		if (vi > ve || (vi == ve && i < e))
+			e = i;
+	}
+
+	void merge(entry& e, const entry& other) const { add(e, other); }
+	size_t winner(const entry& e) const { return e; }
+};
+
+// The same tests on a compact copy. cell() returns kUndecided when the
+// range of a value straddles a strip boundary, and exactCell() settles it on
+// the doubles. An entry keeps every point whose range in dimension L reaches
+// the largest lower end seen, since any of them may be the exact maximum;
+// winner() picks among them on the doubles, so the representative is always
+// the exact_cells one.
+template <class View>
+struct compact_cells
+{
+	struct entry
+	{
+		double floor;              // largest lower end in dimension L
+		size_t row;                // a point whose range reaches it
+		std::vector<size_t> more;  // the others
+	};
+
+	const dataset& ds;
+	View view;
+	const compact_dataset& copy;
+	size_t L;
 
-		// If there is a point in this cube and it is distinct from earlier ones, add to list
-		if (cubeBestIndex >= 0)
+	long cell(size_t i, size_t j, double c, int t) const
+	{
+		double lo, hi;
+		view.range(i, j, lo, hi);
+		lo *= t;
+		hi *= t;
+		double b = std::floor(lo / c);
+		// every value in [lo, hi] lies in strip b, so the exact t * v does too
+		if (b >= 0 && b < t && b * c <= lo && hi < (b + 1) * c)
+			return (long)b;
+		// or none of them lies on the grid
+		if (hi < 0 || !(lo < t * c))
+			return -1;
+		return kUndecided;
+	}
+
+	double exactValue(size_t i, size_t j) const { return copy.exactValue(i, j); }
+	long exactCell(size_t i, size_t j, double c, int t) const { return cubeCell(t * exactValue(i, j), c, t); }
+
+	double lower(size_t i) const
+	{
+		double lo, hi;
+		view.range(i, L, lo, hi);
+		return lo;
+	}
+
+	double upper(size_t i) const
+	{
+		double lo, hi;
+		view.range(i, L, lo, hi);
+		return hi;
+	}
+
+	entry start(size_t i) const { return entry{ lower(i), i, {} }; }
+
+	void add(entry& e, size_t i) const
+	{
+		double lo, hi;
+		view.range(i, L, lo, hi);
+		if (hi < e.floor)
+			return;
+		if (lo > e.floor)
 		{
-			seenBefore = 0;
-			for(i = 0; i < index && !seenBefore; ++i)
-				if(equals(answer[i], p[cubeBestIndex]))
-					seenBefore = 1;
+			// drop the points the new floor rules out
+			e.floor = lo;
+			size_t kept = 0;
+			for(size_t r = 0; r < e.more.size(); ++r)
+				if (!(upper(e.more[r]) < lo))
+					e.more[kept++] = e.more[r];
+			e.more.resize(kept);
+			if (upper(e.row) < lo)
+			{
+				e.row = i;
+				return;
+			}
+		}
+		e.more.push_back(i);
+	}
+
+	void merge(entry& e, const entry& other) const
+	{
+		add(e, other.row);
+		for(size_t r = 0; r < other.more.size(); ++r)
+			add(e, other.more[r]);
+	}
 
-			if (!seenBefore)
-				answer[index++] = p[cubeBestIndex];
+	size_t winner(const entry& e) const
+	{
+		if (e.more.empty())
+			return e.row;
+		size_t best = e.row;
+		double top = copy.exactValue(best, L);
+		for(size_t r = 0; r < e.more.size(); ++r)
+		{
+			size_t i = e.more[r];
+			double v = copy.exactValue(i, L);
+			if (v > top || (v == top && i < best))
+			{
+				best = i;
+				top = v;
+			}
 		}
+		return best;
+	}
+};
 
+// The maps bestPerCube fills: the scratch ones when the entries are plain
+// rows, fresh ones for the other entry and key types
+template <class Map>
+static Map& reuse(cube_scratch&, Map& fresh) { return fresh; }
+static cube_scratch::packed_map& reuse(cube_scratch& scratch, cube_scratch::packed_map&) { return scratch.best; }
 
-		// increment t-ary counter
-		if (L == 0) // if we're skipping 0th dimension, start at 1
-			j = 1;
-		else
-			j = 0;
-		boundary[j]++;
-		while(!done && boundary[j] == t)
+template <class Map>
+static std::vector<Map>& reuse(cube_scratch&, std::vector<Map>& fresh) { return fresh; }
+static std::vector<cube_scratch::packed_map>& reuse(cube_scratch& scratch, std::vector<cube_scratch::packed_map>&)
+{
+	return scratch.local;
+}
+
+// Records point i in the entry of its cube
+template <class Map, class Cells>
+static void keepBest(const Cells& cells, Map& best, const typename Map::key_type& key, size_t i)
+{
+	auto it = best.find(key);
+	if (it == best.end())
+		best.emplace(key, cells.start(i));
+	else
+		cells.add(it->second, i);
+}
+
+// Buckets the candidates (all N points if candidates is null) with keyOf,
+// which fills in the cube key of a point and returns 1, 0 for points outside
+// the grid, or -1 when the cells cannot tell without the exact values. Each
+// worker fills its own map and the maps are merged entry by entry, so the
+// result matches a serial scan; the undecided points are then keyed with
+// exact set, one at a time. best, local and undecided are cleared first.
+template <class Map, class Cells, class KeyOf>
+static void bestPerCube(const dataset& ds, const Cells& cells, const size_t *candidates, size_t count,
+	const typename Map::key_type& empty, KeyOf keyOf, Map& best, std::vector<Map>& local,
+	std::vector<std::vector<size_t>>& undecided)
+{
+	size_t N = candidates ? count : ds.n;
+	best.clear();
+	undecided.resize(workerCount());
+	for (size_t w = 0; w < undecided.size(); ++w)
+		undecided[w].clear();
+	auto scan = [&](size_t lo, size_t hi, Map& into, std::vector<size_t>& later) {
+		typename Map::key_type key = empty;
+		for (size_t n = lo; n < hi; ++n)
 		{
-			boundary[j] = 0;  // reset position
-			j++;
-			if (j == L) j++;  // if we reach the skipped dimension, skip it
+			size_t i = candidates ? candidates[n] : n;
+			int found = keyOf(i, key, false);
+			if (found > 0)
+				keepBest(cells, into, key, i);
+			else if (found < 0)
+				later.push_back(i);
+		}
+	};
 
-			if (j < D)
-				boundary[j]++; // if not at the end, do the carry
-			else
-				done = true;      // else indicate that all combinations tried
+	if (workerCount() == 1 || N <= kBucketGrain)
+		scan(0, N, best, undecided[0]);
+	else
+	{
+		local.resize(workerCount());
+		parallelFor(0, N, kBucketGrain, [&](size_t lo, size_t hi, size_t w) {
+			scan(lo, hi, local[w], undecided[w]);
+		});
+
+		for (size_t w = 0; w < local.size(); ++w)
+		{
+			for (auto it = local[w].begin(); it != local[w].end(); ++it)
+			{
+				auto into = best.try_emplace(it->first, std::move(it->second));
+				if (!into.second)
+					cells.merge(into.first->second, it->second);
+			}
+			local[w].clear();
 		}
 	}
 
+	typename Map::key_type key = empty;
+	for (size_t w = 0; w < undecided.size(); ++w)
+		for (size_t n = 0; n < undecided[w].size(); ++n)
+			if (keyOf(undecided[w][n], key, true) > 0)
+				keepBest(cells, best, key, undecided[w][n]);
+}
+
+static bool packedIds(size_t D, size_t L, int t, double& radix)
+{
+// Cube ids are packed into 64 bits unless t^(D-1) would overflow
+	radix = 1.0;
+	for(size_t j = 0; j < D; ++j)
+		if (j != L)
+			radix *= t;
+	return radix < 18446744073709551615.0;
+}
+
+template <class Cells>
+static void occupiedCubes(const dataset& ds, const Cells& cells, size_t L, int t, const double *width,
+	const size_t *candidates, size_t count, bool packed, cube_scratch& scratch)
+{
+// Buckets the candidates with cells and lists the representative of every
+// occupied cube in the order of the t-ary counter to scratch.order, which the
+// caller has cleared. width[j] is the value of the maximal point in dimension j.
+	size_t D = ds.d;
+
+	auto cellOf = [&](size_t i, size_t j, bool exact) {
+		return exact ? cells.exactCell(i, j, width[j], t) : cells.cell(i, j, width[j], t);
+	};
+
+	std::vector<size_t>& order = scratch.order;
+	if (packed)
+	{
+		typedef packed_cells<typename Cells::entry> packed_map;
+		packed_map freshBest;
+		std::vector<packed_map> freshLocal;
+		packed_map& best = reuse(scratch, freshBest);
+
+		bestPerCube(ds, cells, candidates, count, (uint64_t)0, [&](size_t i, uint64_t& id, bool exact) {
+			uint64_t weight = 1;
+			id = 0;
+			for(size_t j = 0; j < D; ++j)
+				if (j != L)
+				{
+					long b = cellOf(i, j, exact);
+					if (b == kUndecided)
+						return -1;
+					if (b < 0)
+						return 0;
+					id += (uint64_t)b * weight;
+					weight *= (uint64_t)t;
+				}
+			return 1;
+		}, best, reuse(scratch, freshLocal), scratch.undecided);
+
+		std::vector<std::pair<uint64_t, size_t>>& ids = scratch.ids;
+		ids.clear();
+		ids.reserve(best.size());
+		for(auto it = best.begin(); it != best.end(); ++it)
+			ids.emplace_back(it->first, cells.winner(it->second));
+		std::sort(ids.begin(), ids.end());
+		order.reserve(ids.size());
+		for(size_t i = 0; i < ids.size(); ++i)
+			order.push_back(ids[i].second);
+	}
+	else
+	{
+		// keys hold the most significant counter digit first
+		std::map<std::vector<long>, typename Cells::entry> best;
+		std::vector<decltype(best)> local;
+
+		bestPerCube(ds, cells, candidates, count, std::vector<long>(D - 1), [&](size_t i, std::vector<long>& key, bool exact) {
+			size_t digit = D - 1;
+			for(size_t j = 0; j < D; ++j)
+				if (j != L)
+				{
+					long b = cellOf(i, j, exact);
+					if (b == kUndecided)
+						return -1;
+					if (b < 0)
+						return 0;
+					key[--digit] = b;
+				}
+			return 1;
+		}, best, local, scratch.undecided);
+
+		order.reserve(best.size());
+		for(auto it = best.begin(); it != best.end(); ++it)
+			order.push_back(cells.winner(it->second));
+	}
+}
+
+int cubeAnswer(const dataset& ds, int K, size_t L, const size_t* c, const std::vector<size_t>& order, size_t* answer,
+	const compact_dataset* compact, cube_scratch* scratch)
+{
+	size_t D = ds.d;
+	size_t i, index, cell, duplicates;
+	distinct_rows own;
+	distinct_rows& seen = scratch ? scratch->seen : own;
+	seen.reset(ds, compact);
+
+	index = 0;
+	// first list the maximal points in the directions {1,...,D}\L
+	for(i = 0; i < D; ++i)
+		if (i != L)
+		{
+			answer[index++] = c[i];
+			seen.insert(c[i]);
+		}
+
+	// add each cube's point if it is distinct from earlier ones
+	duplicates = 0;
+	for(cell = 0; cell < order.size() && index < (size_t)K; ++cell)
+		if (seen.insert(order[cell]))
+			answer[index++] = order[cell];
+		else
+			duplicates++;
+
+	if (statsEnabled())
+	{
+		addStat(stat_counter::cells_walked, cell);
+		addStat(stat_counter::dedup_hits, duplicates);
+	}
+
 	// fill in any remaining positions with the first point found
-	for(i = index; i < K; ++i)
+	for(i = index; i < (size_t)K; ++i)
 		answer[i] = answer[0];
 
 	return index;
 }
 
-void cube(size_t D, size_t N, int K, struct point *p, int *maxIndex)
+static int cubePass(const dataset& ds, int K, size_t L, int t, const size_t *c,
+	const size_t *candidates, size_t count, size_t *answer, size_t *occupied, const compact_dataset* compact,
+	cube_scratch& scratch)
+{
+// Buckets every candidate point into its cube once, keeping the point that is
+// maximal in dimension L for each occupied cube, then walks the occupied cubes
+// in the order of the t-ary counter (first free dimension least significant).
+// A null candidate list means all N points. Points are tracked by row index.
+// With a compact copy the cubes are found on it, with the same result.
+	stat_timer timer(stat_phase::cube_pass);
+	size_t D = ds.d, N = candidates ? count : ds.n;
+	size_t j, scanned = 0;
+	double radix;
+	bool packed = packedIds(D, L, t, radix);
+
+	std::vector<double> width(D);
+	for(j = 0; j < D; ++j)
+		width[j] = compact ? compact->exactValue(c[j], j) : ds.value(c[j], j);
+
+	std::vector<size_t>& order = scratch.order; // maximal point of each occupied cube, in counter order
+	order.clear();
+	// the D - 1 boundary points come first
+	if (D - 1 < (size_t)K)
+	{
+		scanned = N;
+		if (compact && compact->bounded())
+			compact->visit([&](auto view) {
+				compact_cells<decltype(view)> cells{ ds, view, *compact, L };
+				occupiedCubes(ds, cells, L, t, width.data(), candidates, count, packed, scratch);
+			});
+		else
+			occupiedCubes(ds, exact_cells{ ds, L }, L, t, width.data(), candidates, count, packed, scratch);
+	}
+
+	if (occupied)
+		*occupied = order.size();
+
+	if (statsEnabled())
+	{
+		addStat(stat_counter::points_scanned, scanned);
+		addStat(stat_counter::cells_occupied, order.size());
+	}
+
+	return cubeAnswer(ds, K, L, c, order, answer, compact, &scratch);
+}
+
+int cubealgorithm(const dataset& ds, int K, size_t L, int t, const size_t *c, size_t *answer)
+{
+	cube_scratch scratch;
+	return cubePass(ds, K, L, t, c, nullptr, 0, answer, nullptr, nullptr, scratch);
+}
+
+void occupiedCells(const dataset& ds, int t, const double* upper, const size_t* candidates, size_t count,
+	std::vector<size_t>& rows, std::vector<long>& keys, cube_scratch* buffers)
 {
-	int i, j, t, distinct;
-	size_t L = D - 1;
-	std::vector<point> c(D); // maximal points in each direction
-	std::vector<point> answer(K + 1);
+	stat_timer timer(stat_phase::cube_pass);
+	size_t D = ds.d, L = D - 1;
+	double radix;
+	bool packed = packedIds(D, L, t, radix);
+	cube_scratch own;
+	cube_scratch& scratch = buffers ? *buffers : own;
+
+	scratch.order.clear();
+	occupiedCubes(ds, exact_cells{ ds, L }, L, t, upper, candidates, count, packed, scratch);
+	rows = scratch.order;
+
+	// L is the last dimension, so the free ones are 0..D-2, least significant first
+	keys.resize(rows.size() * L);
+	for(size_t r = 0; r < rows.size(); ++r)
+		for(size_t j = 0; j < L; ++j)
+			keys[r * L + (L - 1 - j)] = cubeCell(t * ds.value(rows[r], j), upper[j], t);
+
+	if (statsEnabled())
+	{
+		addStat(stat_counter::points_scanned, count);
+		addStat(stat_counter::cells_occupied, rows.size());
+	}
+}
+
+void gridCandidates(const dataset& ds, const double* upper, std::vector<size_t>& candidates,
+	const compact_dataset* compact, cube_scratch* buffers)
+{
+// Points outside [0, c_j) in a free dimension never fall in any cube, for any t
+	size_t D = ds.d, N = ds.n;
+	cube_scratch own;
+	std::vector<char>& inside = (buffers ? *buffers : own).inside;
+
+	inside.assign(N, 0);
+	candidates.clear();
+	// L is the last dimension, so the free ones are 0..D-2; a compact copy
+	// settles a test unless the range of the value contains 0 or c_j
+	if (compact && compact->bounded())
+		compact->visit([&](auto view) {
+			parallelFor(0, N, kBucketGrain, [&](size_t lo, size_t hi, size_t) {
+				for(size_t i = lo; i < hi; ++i)
+				{
+					bool in = true;
+					for(size_t j = 0; j + 1 < D && in; ++j)
+					{
+						double low, high;
+						view.range(i, j, low, high);
+						if (low >= 0 && high < upper[j])
+							continue;
+						if (high < 0 || low >= upper[j])
+							in = false;
+						else
+						{
+							double v = compact->exactValue(i, j);
+							in = v >= 0 && v < upper[j];
+						}
+					}
+					inside[i] = in;
+				}
+			});
+			compact->releaseExact();
+		});
+	else
+		parallelFor(0, N, kBucketGrain, [&](size_t lo, size_t hi, size_t) {
+			dispatchDimension(D, [&](auto fd) {
+				constexpr size_t FD = decltype(fd)::value;
+				const size_t n = FD ? FD : D;
+				for(size_t i = lo; i < hi; ++i)
+				{
+					bool in = true;
+					for(size_t j = 0; j + 1 < n; ++j)
+						in &= ds.value(i, j) >= 0 && ds.value(i, j) < upper[j];
+					inside[i] = in;
+				}
+			});
+		});
+	for(size_t i = 0; i < N; ++i)
+		if (inside[i])
+			candidates.push_back(i);
+}
+
+cube_solver::cube_solver(const dataset& data, int maxK, const cube_options& opts, const compact_dataset* copy,
+	cube_scratch* buffers)
+	: ds(data), options(opts), limit(std::max(maxK, 1)), c(data.d), compact(copy),
+	  own(buffers ? nullptr : new cube_scratch()), scratch(buffers ? buffers : own.get())
+{
+	size_t D = ds.d;
+	size_t j;
 
 	// compute the maximal points in each of the D directions
-	for(i = 0; i < D; ++i)
-		c[i] = p[0]; // initialize with first point
-	for(i = 0; i < N; ++i)
-		for(j = 0; j < D; ++j)
-			if (p[i].a[j] > c[j].a[j])
-				c[j] = p[i];
+	if (compact)
+		compact->argmax(c.data());
+	else
+		columnArgMax(ds, c.data());
+
+	std::vector<double> upper(D);
+	for(j = 0; j < D; ++j)
+		upper[j] = compact ? compact->exactValue(c[j], j) : ds.value(c[j], j);
+	gridCandidates(ds, upper.data(), scratch->candidates, compact, scratch);
+}
+
+const cube_pass& cube_solver::run(int t)
+{
+// The pass for grid size t, made for the largest K and kept, so that a t is
+// never evaluated twice
+	auto it = passes.find(t);
+	if (it == passes.end())
+	{
+		cube_pass r;
+		size_t occupied = 0;
+		const std::vector<size_t>& candidates = scratch->candidates;
+		r.answer.resize(std::max<size_t>(limit, ds.d) + 1);
+		r.distinct = cubePass(ds, limit, ds.d - 1, t, c.data(), candidates.data(), candidates.size(), r.answer.data(), &occupied,
+			compact, *scratch);
+		// once every distinct candidate sits in its own cube a finer grid cannot
+		// find more points; the rows only need hashing when some of them share a cube
+		r.saturated = occupied == candidates.size() ||
+			atMostDistinct(ds, candidates.data(), candidates.size(), occupied, compact, scratch);
+		if (compact)
+			compact->releaseExact();
+		it = passes.emplace(t, std::move(r)).first;
+	}
+	return it->second;
+}
+
+int searchGrid(size_t D, size_t N, int K, const cube_options& options, const std::function<const cube_pass&(int)>& run)
+{
+	int t, t0, lo, hi, step;
+	size_t boundary = D - 1;
+	std::set<int> visited; // passes this selection has looked at
+
+	// A pass for K stops at a prefix of the list made for the largest K: the
+	// D - 1 boundary points always, then distinct cube points up to K
+	auto distinct = [&](int t) {
+		visited.insert(t);
+		const cube_pass& r = run(t);
+		return boundary >= (size_t)K ? (int)boundary : std::min(r.distinct, K);
+	};
+	auto done = [&](int t) {
+		int found = distinct(t);
+		return found >= K || (size_t)found >= N || run(t).saturated;
+	};
+	auto capped = [&]() { return (int)visited.size() >= options.maxPasses; };
 
 	// initialize t as in the cube algorithm
-	t = (int)pow(K - D + 1.0, 1.0/(D - 1.0));
+	t0 = std::max(1, (int)pow(K - D + 1.0, 1.0/(D - 1.0)));
 
-	// keep looping until we find at least K distinct points
-	do
+	if (options.search == cube_search::linear)
+	{
+		// step t until we find at least K distinct points
+		for(t = t0; !done(t) && !capped(); ++t)
+			;
+	}
+	else
 	{
-		distinct = cubealgorithm(D, N, K, p, L, t, c.data(), answer.data());
-		t++;
+		// gallop until a pass finds K points, then bisect the last gap
+		lo = t0 - 1;
+		hi = t0;
+		step = 1;
+		while(!done(hi) && !capped() && hi <= std::numeric_limits<int>::max() / 2)
+		{
+			lo = hi;
+			hi += step;
+			step *= 2;
+		}
+		while(hi - lo > 1 && !capped())
+		{
+			int mid = lo + (hi - lo) / 2;
+			if (done(mid))
+				hi = mid;
+			else
+				lo = mid;
+		}
+		t = hi;
 	}
-	while(distinct < K && distinct < N);
 
-	if (distinct > K)
-		cubealgorithm(D, N, K, p, L, t - 2, c.data(), answer.data());
+	if (distinct(t) > K)
+		t = t - 1;
+	countStat(stat_counter::t_values, visited.size());
+	return t;
+}
+
+void cube_solver::select(int K, int *maxIndex, int *grid)
+{
+	int t = searchGrid(ds.d, ds.n, K, options, [&](int t) -> const cube_pass& { return run(t); });
+	const cube_pass& chosen = run(t);
+	if (grid)
+		*grid = t;
+
+	// the passes carry row indices, so they are already in the desired format
+	for(size_t j = 0; j < (size_t)K; ++j)
+		maxIndex[j] = (int)chosen.answer[j];
+}
 
-	// get the indices, to be in the desired format
-	for(i = 0; i < N; ++i)
-		for(j = 0; j < K; ++j)
-			if (equals(p[i], answer[j]))
-				maxIndex[j] = i;
+void cube(const dataset& ds, int K, int *maxIndex, const cube_options& options, const compact_dataset* compact,
+	cube_scratch* scratch)
+{
+	cube_solver(ds, K, options, compact, scratch).select(K, maxIndex);
+}
+
+void cube(size_t D, size_t N, int K, struct point *p, int *maxIndex)
+{
+	cube(datasetFromPoints(p, D, N), K, maxIndex);
 }
@@ -18,70 +18,322 @@
 //==========================================================================================
 
 #include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
 #include <cstring>
-#include <fstream>
 #include <iostream>
-#include <sstream>
 #include <string>
 #include <vector>
 
 #include <kregret/data_reader.h>
+#include <kregret/dataset_stats.h>
+#include <kregret/mapped_file.h>
+#include <kregret/parallel.h>
+#include <kregret/stats.h>
 
+namespace {
 
-std::vector<std::vector<double>> processData(const char* filename,const char sep, size_t& D, size_t& N) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: Cannot open file " << filename << std::endl;
-        exit(2);
+// Bytes of parsed or counted text after which its pages are handed back
+const size_t kReleaseEvery = 8 << 20;
+
+struct parse_warning
+{
+    size_t line;  // line number relative to the start of the chunk
+    std::string text;
+};
+
+// Rows parsed from one newline-aligned slice of the file. Rows are written
+// straight into out when it is set, otherwise they are appended to values.
+// stats summarizes them as they are parsed, by their index in the chunk.
+struct parsed_chunk
+{
+    double* out = nullptr;
+    std::vector<double> values;
+    size_t rows = 0;
+    size_t lines = 0;
+    size_t width = 0;
+    dataset_stats stats;
+    std::vector<parse_warning> warnings;
+};
+
+inline bool isTrimmed(char ch) {
+    return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
+}
+
+// Parses one trimmed field the way std::stod would, reporting why it failed
+bool parseValue(const char* first, const char* last, double& out, const char*& error) {
+    const char* p = first;
+    if (p != last && *p == '+' && p + 1 != last && p[1] != '-' && p[1] != '+') {
+        ++p;
     }
 
-    std::vector<std::vector<double>> data;
-    std::string line;
-    int lineNumber = 0;
-    D = 0;
+    const char* digits = (p != last && *p == '-') ? p + 1 : p;
+    if (last - digits > 1 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X')) {
+        // from_chars has no 0x prefix; hex values are rare enough to hand to strtod
+        std::string copy(first, last);
+        char* end = nullptr;
+        errno = 0;
+        out = std::strtod(copy.c_str(), &end);
+        if (end == copy.c_str()) { error = "invalid number"; return false; }
+        if (errno == ERANGE) { error = "out of range"; return false; }
+        return true;
+    }
+
+    std::from_chars_result r = std::from_chars(p, last, out);
+    if (r.ec == std::errc::invalid_argument) { error = "invalid number"; return false; }
+    if (r.ec == std::errc::result_out_of_range) { error = "out of range"; return false; }
+    return true;
+}
 
-    // Read CSV file
-    while (std::getline(file, line)) {
+// Number of lines std::getline would read from [begin, end)
+size_t countLines(const char* begin, const char* end) {
+    size_t lines = 0;
+    for (const char* p = begin; p < end; ++p) {
+        p = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (p == nullptr) {
+            return lines + 1;
+        }
+        lines++;
+    }
+    return lines;
+}
+
+// Same, handing the counted pages back as it goes: the parse faults them in
+// again a piece at a time, so the text is never resident all at once
+size_t countLines(const mapped_file& file, const char* begin, const char* end) {
+    size_t lines = begin < end && end[-1] != '\n' ? 1 : 0;
+    for (const char* piece = begin; piece < end; ) {
+        const char* stop = piece + std::min<size_t>(kReleaseEvery, end - piece);
+        for (const char* p = piece; (p = static_cast<const char*>(memchr(p, '\n', stop - p))) != nullptr; ++p) {
+            lines++;
+        }
+        releasePages(file, piece, stop);
+        piece = stop;
+    }
+    return lines;
+}
 
-        lineNumber++;
-        std::vector<double> row;
-        std::stringstream ss(line);
-        std::string value;
+// Parses the lines in [begin, end). D is the expected row width, unless
+// widthFromFirstLine is set, in which case the first line defines it.
+void parseChunk(const mapped_file& file, const char* begin, const char* end, char sep, size_t D,
+                parsed_chunk& chunk, bool widthFromFirstLine = false) {
+    std::vector<double> row;
+    const char* line = begin;
+    const char* released = begin;
+    chunk.stats = dataset_stats(D);
+
+    while (line < end) {
+        const char* eol = static_cast<const char*>(memchr(line, '\n', end - line));
+        if (eol == nullptr) eol = end;
+        chunk.lines++;
+
+        double* slot = chunk.out ? chunk.out + chunk.rows * D : nullptr;
+        size_t count = 0;
+        row.clear();
+        const char* field = line;
+        while (field < eol) {
+            const char* stop = static_cast<const char*>(memchr(field, sep, eol - field));
+            if (stop == nullptr) stop = eol;
 
-        while (std::getline(ss, value, sep)) {
             // Remove any whitespace
-            value.erase(0, value.find_first_not_of(" \t\r\n"));
-            value.erase(value.find_last_not_of(" \t\r\n") + 1);
+            const char* first = field;
+            const char* last = stop;
+            while (first < last && isTrimmed(*first)) first++;
+            while (last > first && isTrimmed(last[-1])) last--;
 
-            if (!value.empty()) {
-                try {
-                    row.push_back(std::stod(value));
+            if (first < last) {
+                double value;
+                const char* error = nullptr;
+                if (parseValue(first, last, value, error)) {
+                    if (slot == nullptr) {
+                        row.push_back(value);
+                    }
+                    else if (count < D) {
+                        slot[count] = value;
+                    }
+                    count++;
                 }
-                catch (const std::exception& e) {
-                    std::cerr << "Warning: Error parsing value '" << value
-                        << "' at line " << lineNumber
-                        << " (" << e.what() << ")" << std::endl;
-                    continue;
+                else {
+                    chunk.warnings.push_back({ chunk.lines, "Warning: Error parsing value '" + std::string(first, last)
+                        + "' at line %LINE% (" + error + ")" });
                 }
             }
+            field = stop + 1;
         }
-        if (lineNumber == 1) { D = row.size(); }
-        if (row.size() == D) {
-            data.push_back(row);
+
+        if (widthFromFirstLine && chunk.lines == 1) {
+            D = count;
+            chunk.stats = dataset_stats(D);
         }
-        else if (!row.empty()) {
-            std::cerr << "Warning: Line " << lineNumber << " has " << row.size()
-                << " values, expected " << D << ". Skipping." << std::endl;
+        if (count == D) {
+            if (slot == nullptr) {
+                chunk.values.insert(chunk.values.end(), row.begin(), row.end());
+            }
+            chunk.stats.add(slot ? slot : row.data(), chunk.rows);
+            chunk.rows++;
+        }
+        else if (count != 0) {
+            chunk.warnings.push_back({ chunk.lines, "Warning: Line %LINE% has " + std::to_string(count)
+                + " values, expected " + std::to_string(D) + ". Skipping." });
+        }
+
+        line = eol + 1;
+
+        // Parsed text is not needed again, so hand its pages back as we go
+        if ((size_t)(line - released) >= kReleaseEvery) {
+            releasePages(file, released, line);
+            released = line;
         }
     }
-    file.close();
+    chunk.width = D;
+}
+
+void printWarning(const parse_warning& warning, size_t firstLine) {
+    std::string text = warning.text;
+    size_t pos = text.find("%LINE%");
+    text.replace(pos, 6, std::to_string(firstLine + warning.line - 1));
+    std::cerr << text << std::endl;
+}
+
+// Start of the first line that begins at or after p
+const char* lineStart(const char* fileBegin, const char* p, const char* end) {
+    if (p <= fileBegin) {
+        return fileBegin;
+    }
+    const char* eol = p - 1 < end ? static_cast<const char*>(memchr(p - 1, '\n', end - (p - 1))) : nullptr;
+    return eol ? eol + 1 : end;
+}
 
-    N = data.size();
+}
+
+read_status readDataset(const char* filename, char sep, dataset& out) {
+    return readDatasetSlice(filename, sep, 0, 1, out);
+}
+
+read_status readDatasetSlice(const char* filename, char sep, size_t slice, size_t slices, dataset& out) {
+    stat_timer timer(stat_phase::parse);
+    mapped_file file = mapFile(filename);
+    if (!file.isOpen()) {
+        return read_status::cannot_open;
+    }
+
+    const char* begin = file.data;
+    const char* end = file.data + file.size;
+    size_t D = 0;
+
+    // The first line fixes the number of dimensions; its row belongs to slice 0
+    parsed_chunk first;
+    if (begin < end) {
+        const char* eol = static_cast<const char*>(memchr(begin, '\n', end - begin));
+        const char* firstEnd = eol ? eol + 1 : end;
+        parseChunk(file, begin, firstEnd, sep, 0, first, true);
+        D = first.width;
+
+        // A slice holds the lines that start in its share of the bytes
+        const char* sliceBegin = std::max(firstEnd, lineStart(file.data, begin + file.size * slice / slices, end));
+        const char* sliceEnd = std::max(sliceBegin, lineStart(file.data, begin + file.size * (slice + 1) / slices, end));
+        if (slice > 0) {
+            first = parsed_chunk();
+            first.width = D;
+        }
+        begin = sliceBegin;
+        end = sliceEnd;
+    }
+
+    // Split the rest into newline-aligned chunks, one per worker
+    size_t chunks = std::max<size_t>(1, std::min<size_t>(workerCount(), (end - begin) / (1 << 20) + 1));
+    std::vector<const char*> bounds(chunks + 1, end);
+    bounds[0] = begin;
+    for (size_t c = 1; c < chunks; ++c) {
+        const char* p = std::max(bounds[c - 1], begin + (end - begin) * c / chunks);
+        const char* eol = p < end ? static_cast<const char*>(memchr(p, '\n', end - p)) : nullptr;
+        bounds[c] = eol ? eol + 1 : end;
+    }
+
+    // Every line yields at most one row, so counting lines bounds each chunk's
+    // rows and the whole dataset can be allocated once, up front
+    std::vector<size_t> offset(chunks + 1, first.rows);
+    parallelFor(0, chunks, [&](size_t lo, size_t hi, size_t) {
+        for (size_t c = lo; c < hi; ++c) {
+            offset[c + 1] = countLines(file, bounds[c], bounds[c + 1]);
+        }
+    });
+    for (size_t c = 0; c < chunks; ++c) {
+        offset[c + 1] += offset[c];
+    }
+
+    dataset ds = allocateDataset(D, offset[chunks]);
+    std::copy(first.values.begin(), first.values.end(), ds.base);
+
+    std::vector<parsed_chunk> parsed(chunks);
+    parallelFor(0, chunks, [&](size_t lo, size_t hi, size_t) {
+        for (size_t c = lo; c < hi; ++c) {
+            parsed[c].out = ds.row(offset[c]);
+            parseChunk(file, bounds[c], bounds[c + 1], sep, D, parsed[c]);
+        }
+    });
+
+    // Report warnings in file order and close the gaps left by skipped lines;
+    // the chunk summaries are combined at the final row positions
+    dataset_stats stats(D);
+    stats.merge(first.stats);
+    size_t lineNumber = 1;
+    if (slice > 0 && std::any_of(parsed.begin(), parsed.end(), [](const parsed_chunk& c) { return !c.warnings.empty(); })) {
+        // the lines before the slice are only counted to number its warnings
+        lineNumber += countLines(file.data, begin);
+    }
+    for (const parse_warning& warning : first.warnings) {
+        printWarning(warning, lineNumber);
+    }
+    lineNumber += first.lines;
+    size_t N = first.rows;
+    for (size_t c = 0; c < chunks; ++c) {
+        for (const parse_warning& warning : parsed[c].warnings) {
+            printWarning(warning, lineNumber);
+        }
+        lineNumber += parsed[c].lines;
+        if (offset[c] != N && parsed[c].rows > 0) {
+            memmove(ds.row(N), ds.row(offset[c]), parsed[c].rows * D * sizeof(double));
+        }
+        stats.merge(parsed[c].stats, N);
+        N += parsed[c].rows;
+    }
+    ds.n = N;
+    ds.stats = std::make_shared<dataset_stats>(std::move(stats));
 
     if (N == 0) {
+        return read_status::no_data;
+    }
+
+    out = ds;
+    return read_status::ok;
+}
+
+dataset readDataset(const char* filename, const char sep) {
+    dataset ds;
+    switch (readDataset(filename, sep, ds)) {
+    case read_status::cannot_open:
+        std::cerr << "Error: Cannot open file " << filename << std::endl;
+        exit(2);
+    case read_status::no_data:
         std::cerr << "Error: No valid data found in file" << std::endl;
         exit(3);
+    default:
+        return ds;
     }
+}
 
+std::vector<std::vector<double>> processData(const char* filename,const char sep, size_t& D, size_t& N) {
+    dataset ds = readDataset(filename, sep);
+    D = ds.d;
+    N = ds.n;
+
+    stat_timer timer(stat_phase::convert);
+    std::vector<std::vector<double>> data;
+    data.reserve(N);
+    for (size_t i = 0; i < N; ++i) {
+        data.emplace_back(ds.row(i), ds.row(i) + D);
+    }
     return data;
-}
\ No newline at end of file
+}
@@ -0,0 +1,218 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#include <kregret/dataset.h>
+#include <kregret/dataset_stats.h>
+#include <kregret/kernels.h>
+#include <kregret/parallel.h>
+#include <kregret/stats.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+static const size_t kAlignment = 64;
+// Rows per chunk of the column maximum search
+static const size_t kArgMaxGrain = 1 << 16;
+static const size_t kNoRow = (size_t)-1;
+
+static double* alignedAlloc(size_t count)
+{
+	size_t bytes = ((count * sizeof(double) + kAlignment - 1) / kAlignment) * kAlignment;
+	if (bytes == 0)
+		bytes = kAlignment;
+#if defined(_MSC_VER)
+	return static_cast<double*>(_aligned_malloc(bytes, kAlignment));
+#else
+	return static_cast<double*>(std::aligned_alloc(kAlignment, bytes));
+#endif
+}
+
+static void alignedFree(void* ptr)
+{
+#if defined(_MSC_VER)
+	_aligned_free(ptr);
+#else
+	std::free(ptr);
+#endif
+}
+
+point dataset::at(size_t i) const
+{
+	point p;
+	p.d = d;
+	p.a = row(i);
+	return p;
+}
+
+dataset allocateDataset(size_t D, size_t N, layout l)
+{
+	dataset ds;
+	ds.d = D;
+	ds.n = N;
+	ds.base = alignedAlloc(D * N);
+	if (ds.base == nullptr)
+		throw std::bad_alloc();
+	ds.storage = std::shared_ptr<void>(ds.base, alignedFree);
+	if (l == layout::row_major)
+	{
+		ds.rowStride = D;
+		ds.colStride = 1;
+	}
+	else
+	{
+		ds.rowStride = 1;
+		ds.colStride = N;
+	}
+	return ds;
+}
+
+dataset datasetView(double* base, size_t D, size_t N, size_t rowStride, size_t colStride)
+{
+	dataset ds;
+	ds.d = D;
+	ds.n = N;
+	ds.base = base;
+	ds.rowStride = rowStride;
+	ds.colStride = colStride;
+	return ds;
+}
+
+dataset convertLayout(const dataset& ds, layout l)
+{
+	stat_timer timer(stat_phase::convert);
+	dataset out = allocateDataset(ds.d, ds.n, l);
+	out.stats = ds.stats; // same rows in the same order
+	if (l == layout::row_major)
+	{
+		for (size_t i = 0; i < ds.n; ++i)
+			for (size_t j = 0; j < ds.d; ++j)
+				out.value(i, j) = ds.value(i, j);
+	}
+	else
+	{
+		for (size_t j = 0; j < ds.d; ++j)
+			for (size_t i = 0; i < ds.n; ++i)
+				out.value(i, j) = ds.value(i, j);
+	}
+	return out;
+}
+
+dataset datasetFromRows(const std::vector<std::vector<double>>& data, size_t D, size_t N, layout l)
+{
+	stat_timer timer(stat_phase::convert);
+	dataset ds = allocateDataset(D, N, l);
+	for (size_t i = 0; i < N; ++i)
+		for (size_t j = 0; j < D; ++j)
+			ds.value(i, j) = data[i][j];
+	return ds;
+}
+
+dataset datasetFromPoints(const struct point* p, size_t D, size_t N, layout l)
+{
+	stat_timer timer(stat_phase::convert);
+	dataset ds = allocateDataset(D, N, l);
+	for (size_t i = 0; i < N; ++i)
+		for (size_t j = 0; j < D; ++j)
+			ds.value(i, j) = p[i].a[j];
+	return ds;
+}
+
+dataset selectRows(const dataset& ds, const std::vector<size_t>& rows, layout l)
+{
+	dataset out = allocateDataset(ds.d, rows.size(), l);
+	for (size_t i = 0; i < rows.size(); ++i)
+		for (size_t j = 0; j < ds.d; ++j)
+			out.value(i, j) = ds.value(rows[i], j);
+	return out;
+}
+
+void columnArgMax(const dataset& ds, size_t* argmax)
+{
+// Index of the first point attaining the maximum in each dimension. Each
+// worker reduces its chunks; the lowest index wins among equal values, so
+// the result does not depend on how the rows were split. A known summary
+// already holds the answer.
+	if (ds.stats && ds.stats->covers(ds))
+	{
+		std::copy(ds.stats->argmax.begin(), ds.stats->argmax.end(), argmax);
+		return;
+	}
+
+	size_t D = ds.d, j, w;
+	size_t workers = workerCount();
+	std::vector<size_t> partial(workers * D, kNoRow);
+
+	auto better = [&](size_t i, size_t k, size_t j) {
+		return k == kNoRow || ds.value(i, j) > ds.value(k, j) || (ds.value(i, j) == ds.value(k, j) && i < k);
+	};
+
+	parallelFor(0, ds.n, kArgMaxGrain, [&](size_t lo, size_t hi, size_t w) {
+		size_t* best = &partial[w * D];
+		std::vector<size_t> local(D, lo);
+		size_t i, j;
+
+		if (ds.columnMajor())
+		{
+			for (j = 0; j < D; ++j)
+			{
+				const double* col = ds.column(j);
+				for (i = lo + 1; i < hi; ++i)
+					if (col[i] > col[local[j]])
+						local[j] = i;
+			}
+		}
+		else
+		{
+			// keeping the running maxima in registers lets a fixed D unroll
+			dispatchDimension(D, [&](auto fd) {
+				constexpr size_t FD = decltype(fd)::value;
+				const size_t n = FD ? FD : D;
+				double top[FD ? FD : 1];
+				std::vector<double> spill(FD ? 0 : D);
+				double* maxima = FD ? top : spill.data();
+				for (size_t j = 0; j < n; ++j)
+					maxima[j] = ds.value(lo, j);
+				for (size_t i = lo + 1; i < hi; ++i)
+					for (size_t j = 0; j < n; ++j)
+						if (ds.value(i, j) > maxima[j])
+						{
+							maxima[j] = ds.value(i, j);
+							local[j] = i;
+						}
+			});
+		}
+
+		for (j = 0; j < D; ++j)
+			if (better(local[j], best[j], j))
+				best[j] = local[j];
+	});
+
+	for (j = 0; j < D; ++j)
+	{
+		argmax[j] = kNoRow;
+		for (w = 0; w < workers; ++w)
+			if (partial[w * D + j] != kNoRow && better(partial[w * D + j], argmax[j], j))
+				argmax[j] = partial[w * D + j];
+		if (argmax[j] == kNoRow)
+			argmax[j] = 0;
+	}
+}
@@ -0,0 +1,205 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#include <kregret/dataset_cache.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include <kregret/dataset_stats.h>
+#include <kregret/mapped_file.h>
+#include <kregret/stats.h>
+
+static const char kMagic[8] = { 'K', 'R', 'E', 'G', 'R', 'E', 'T', 'B' };
+static const uint32_t kVersion = 1;
+static const uint32_t kByteOrder = 0x01020304;
+static const size_t kColumnAlignment = 64 / sizeof(double);
+// flags: the column summary follows the columns
+static const uint8_t kHasStats = 1;
+
+static uint64_t hashBytes(const char* data, size_t size)
+{
+// FNV-1a over the source bytes
+	uint64_t h = 14695981039346656037ULL;
+	for (size_t i = 0; i < size; ++i)
+		h = (h ^ (unsigned char)data[i]) * 1099511628211ULL;
+	return h;
+}
+
+static bool validHeader(const cache_header& header, size_t fileSize)
+{
+	if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion || header.byteOrder != kByteOrder)
+		return false;
+	if (fileSize < sizeof(cache_header) || header.colStride < header.n)
+		return false;
+	// the fields are untrusted, so they are bounded by the file before any product:
+	// each column takes colStride words, and 4 more with the column summary
+	uint64_t room = (fileSize - sizeof(cache_header)) / sizeof(double);
+	if (header.colStride > room)
+		return false;
+	uint64_t perColumn = std::max<uint64_t>(header.colStride + ((header.flags & kHasStats) ? 4 : 0), 1);
+	return header.d <= room / perColumn;
+}
+
+std::string cachePath(const std::string& source)
+{
+	return source + ".kbin";
+}
+
+bool isDatasetCache(const char* path)
+{
+	cache_header header;
+	std::ifstream in(path, std::ios::binary);
+	if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)))
+		return false;
+	std::error_code ec;
+	uintmax_t size = std::filesystem::file_size(path, ec);
+	return !ec && validHeader(header, (size_t)size);
+}
+
+bool writeDatasetCache(const char* path, const dataset& ds, const char* source, char sep)
+{
+	cache_header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, kMagic, sizeof(kMagic));
+	header.version = kVersion;
+	header.byteOrder = kByteOrder;
+	header.d = ds.d;
+	header.n = ds.n;
+	header.colStride = (ds.n + kColumnAlignment - 1) / kColumnAlignment * kColumnAlignment;
+	header.separator = sep;
+	header.flags = kHasStats;
+
+	mapped_file src = mapFile(source);
+	if (src.isOpen())
+	{
+		header.sourceHash = hashBytes(src.data, src.size);
+		header.sourceSize = src.size;
+	}
+
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	if (!out.is_open())
+		return false;
+
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	std::vector<double> column(header.colStride, 0.0);
+	for (size_t j = 0; j < ds.d; ++j)
+	{
+		if (ds.columnMajor())
+			memcpy(column.data(), ds.column(j), ds.n * sizeof(double));
+		else
+			for (size_t i = 0; i < ds.n; ++i)
+				column[i] = ds.value(i, j);
+		out.write(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(double));
+	}
+
+	// a parsed dataset already carries its summary
+	const dataset_stats stats = ds.stats && ds.stats->covers(ds) ? *ds.stats : computeStats(ds);
+	std::vector<uint64_t> argmax(stats.argmax.begin(), stats.argmax.end());
+	out.write(reinterpret_cast<const char*>(stats.max.data()), ds.d * sizeof(double));
+	out.write(reinterpret_cast<const char*>(stats.min.data()), ds.d * sizeof(double));
+	out.write(reinterpret_cast<const char*>(stats.sum.data()), ds.d * sizeof(double));
+	out.write(reinterpret_cast<const char*>(argmax.data()), ds.d * sizeof(uint64_t));
+
+	return out.good();
+}
+
+bool readDatasetCache(const char* path, dataset& ds, cache_header* header)
+{
+	stat_timer timer(stat_phase::cache_read);
+	mapped_file file = mapFile(path);
+	if (!file.isOpen() || file.size < sizeof(cache_header))
+		return false;
+
+	cache_header h;
+	memcpy(&h, file.data, sizeof(h));
+	if (!validHeader(h, file.size))
+		return false;
+
+	// the mapping is page aligned, so every column starts on a 64-byte boundary
+	dataset out = datasetView(reinterpret_cast<double*>(const_cast<char*>(file.data) + sizeof(cache_header)),
+		h.d, h.n, 1, h.colStride);
+	out.storage = file.handle;
+	if (h.flags & kHasStats)
+	{
+		const char* p = file.data + sizeof(cache_header) + h.d * h.colStride * sizeof(double);
+		auto stats = std::make_shared<dataset_stats>(h.d);
+		std::vector<uint64_t> argmax(h.d);
+		memcpy(stats->max.data(), p, h.d * sizeof(double));
+		memcpy(stats->min.data(), p + h.d * sizeof(double), h.d * sizeof(double));
+		memcpy(stats->sum.data(), p + 2 * h.d * sizeof(double), h.d * sizeof(double));
+		memcpy(argmax.data(), p + 3 * h.d * sizeof(double), h.d * sizeof(uint64_t));
+		stats->argmax.assign(argmax.begin(), argmax.end());
+		stats->rows = h.n;
+		// a summary naming rows the file does not have is ignored
+		if (std::all_of(argmax.begin(), argmax.end(), [&](uint64_t i) { return i < h.n; }))
+			out.stats = stats;
+	}
+	ds = out;
+	if (header)
+		*header = h;
+	return true;
+}
+
+void releaseDatasetCache(const dataset& ds, size_t first, size_t last)
+{
+	mapped_file view;
+	view.data = reinterpret_cast<const char*>(ds.base);
+	view.size = ds.d * ds.colStride * sizeof(double);
+	last = std::min(last, ds.n);
+	for (size_t j = 0; j < ds.d && first < last; ++j)
+		releasePages(view, reinterpret_cast<const char*>(ds.column(j) + first),
+			reinterpret_cast<const char*>(ds.column(j) + last));
+}
+
+bool cacheIsFresh(const char* source, char sep, bool verify)
+{
+	namespace fs = std::filesystem;
+	std::error_code ec;
+	std::string cache = cachePath(source);
+
+	if (!fs::exists(cache, ec) || ec)
+		return false;
+	fs::file_time_type cacheTime = fs::last_write_time(cache, ec);
+	if (ec)
+		return false;
+	fs::file_time_type sourceTime = fs::last_write_time(source, ec);
+	if (ec || cacheTime < sourceTime)
+		return false;
+
+	cache_header header;
+	std::ifstream in(cache, std::ios::binary);
+	if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)))
+		return false;
+
+	uintmax_t cacheSize = fs::file_size(cache, ec);
+	uintmax_t sourceSize = fs::file_size(source, ec);
+	if (ec || !validHeader(header, (size_t)cacheSize) || header.sourceSize != sourceSize || header.separator != sep)
+		return false;
+	if (!verify)
+		return true;
+
+	// as on convert, a source that cannot be mapped (an empty one) hashes to 0
+	mapped_file src = mapFile(source);
+	return (src.isOpen() ? hashBytes(src.data, src.size) : 0) == header.sourceHash;
+}
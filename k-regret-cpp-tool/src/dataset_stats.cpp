@@ -0,0 +1,131 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#include <algorithm>
+
+#include <kregret/dataset_stats.h>
+#include <kregret/kernels.h>
+#include <kregret/parallel.h>
+
+// Rows per chunk of the summary pass
+static const size_t kStatsGrain = 1 << 16;
+
+void dataset_stats::merge(const dataset_stats& other, size_t first)
+{
+	if (other.rows == 0)
+		return;
+	if (rows == 0)
+	{
+		*this = other;
+		for (size_t j = 0; j < argmax.size(); ++j)
+			argmax[j] += first;
+		return;
+	}
+	for (size_t j = 0; j < max.size(); ++j)
+	{
+		size_t at = other.argmax[j] + first;
+		if (other.max[j] > max[j] || (other.max[j] == max[j] && at < argmax[j]))
+		{
+			max[j] = other.max[j];
+			argmax[j] = at;
+		}
+		min[j] = std::min(min[j], other.min[j]);
+		sum[j] += other.sum[j];
+	}
+	rows += other.rows;
+}
+
+dataset_stats computeStats(const dataset& ds)
+{
+	size_t D = ds.d;
+	std::vector<dataset_stats> partial(workerCount(), dataset_stats(D));
+
+	parallelFor(0, ds.n, kStatsGrain, [&](size_t lo, size_t hi, size_t w) {
+		dataset_stats local(D);
+		if (ds.columnMajor())
+		{
+			for (size_t j = 0; j < D; ++j)
+			{
+				const double* col = ds.column(j);
+				double top = col[lo], bottom = col[lo], total = 0.0;
+				size_t at = lo;
+				for (size_t i = lo; i < hi; ++i)
+				{
+					if (col[i] > top)
+					{
+						top = col[i];
+						at = i;
+					}
+					bottom = std::min(bottom, col[i]);
+					total += col[i];
+				}
+				local.max[j] = top;
+				local.min[j] = bottom;
+				local.sum[j] = total;
+				local.argmax[j] = at;
+			}
+		}
+		else
+		{
+			// a fixed D keeps the running values in registers
+			dispatchDimension(D, [&](auto fd) {
+				constexpr size_t FD = decltype(fd)::value;
+				const size_t n = FD ? FD : D;
+				double top[FD ? FD : 1], bottom[FD ? FD : 1], total[FD ? FD : 1];
+				size_t at[FD ? FD : 1];
+				std::vector<double> spill(FD ? 0 : 3 * D);
+				std::vector<size_t> spillAt(FD ? 0 : D);
+				double* maxima = FD ? top : spill.data();
+				double* minima = FD ? bottom : spill.data() + D;
+				double* sums = FD ? total : spill.data() + 2 * D;
+				size_t* rowOf = FD ? at : spillAt.data();
+				for (size_t j = 0; j < n; ++j)
+				{
+					maxima[j] = minima[j] = ds.value(lo, j);
+					sums[j] = 0.0;
+					rowOf[j] = lo;
+				}
+				for (size_t i = lo; i < hi; ++i)
+					for (size_t j = 0; j < n; ++j)
+					{
+						double v = ds.value(i, j);
+						if (v > maxima[j])
+						{
+							maxima[j] = v;
+							rowOf[j] = i;
+						}
+						minima[j] = std::min(minima[j], v);
+						sums[j] += v;
+					}
+				std::copy(maxima, maxima + n, local.max.begin());
+				std::copy(minima, minima + n, local.min.begin());
+				std::copy(sums, sums + n, local.sum.begin());
+				std::copy(rowOf, rowOf + n, local.argmax.begin());
+			});
+		}
+		local.rows = hi - lo;
+		partial[w].merge(local);
+	});
+
+	dataset_stats stats(D);
+	for (size_t w = 0; w < partial.size(); ++w)
+		stats.merge(partial[w]);
+	return stats;
+}
@@ -0,0 +1,299 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+// Cube algorithm kept up to date under insertions and deletions
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
+#include <kregret/dynamic_cube.h>
+
+// Updates absorbed between two rebuilds, at least
+static const size_t kMinRebuildUpdates = 1024;
+
+dynamic_cube::dynamic_cube(const dataset& ds, int K, const cube_options& opts)
+	: d(ds.d), k(K), options(opts), values(ds.d * ds.n), alive(ds.n, 1), live(ds.n),
+	  t(0), packed(false), candidates(0), distinct(0), lastCell(kNoCell), updates(0), rebuildCount(0)
+{
+	for (size_t i = 0; i < ds.n; ++i)
+		for (size_t j = 0; j < d; ++j)
+			values[i * d + j] = ds.value(i, j);
+
+	// room for the insertions until the first scheduled rebuild, so that the
+	// first of them does not copy the whole dataset
+	size_t room = ds.n + std::max(kMinRebuildUpdates, ds.n / 4);
+	values.reserve(room * d);
+	alive.reserve(room);
+
+	rebuild();
+	rebuildCount = 0;
+}
+
+dataset dynamic_cube::livePoints(std::vector<size_t>* ids) const
+{
+	dataset out = allocateDataset(d, live);
+	size_t n = 0;
+
+	if (ids)
+		ids->clear();
+	for (size_t id = 0; id < alive.size(); ++id)
+		if (alive[id])
+		{
+			std::memcpy(out.row(n++), &values[id * d], d * sizeof(double));
+			if (ids)
+				ids->push_back(id);
+		}
+	return out;
+}
+
+uint64_t dynamic_cube::cellOf(size_t id) const
+{
+// Packed cube id of a point, as cubealgorithm() numbers them, or kNoCell
+	uint64_t cell = 0, weight = 1;
+	for (size_t j = 0; j + 1 < d; ++j)
+	{
+		long b = cubeCell(t * value(id, j), value(c[j], j), t);
+		if (b < 0)
+			return kNoCell;
+		cell += (uint64_t)b * weight;
+		weight *= (uint64_t)t;
+	}
+	return cell;
+}
+
+bool dynamic_cube::inside(size_t id) const
+{
+// The candidate filter of cube(): inside [0, c_j) in every free dimension
+	for (size_t j = 0; j + 1 < d; ++j)
+		if (!(value(id, j) >= 0 && value(id, j) < value(c[j], j)))
+			return false;
+	return true;
+}
+
+bool dynamic_cube::add(size_t id, uint64_t& cell)
+{
+// Files a live point under its cube; true if that created the cube or made
+// the point its representative
+	size_t L = d - 1;
+
+	if (inside(id))
+		candidates++;
+	cell = cellOf(id);
+	cellOfRow[id] = cell;
+	if (cell == kNoCell)
+		return false;
+
+	cube_cell& cube = cells[cell];
+	position[id] = cube.members.size();
+	cube.members.push_back(id);
+	if (cube.members.size() == 1 || value(id, L) > value(cube.best, L)
+		|| (value(id, L) == value(cube.best, L) && id < cube.best))
+	{
+		cube.best = id;
+		return true;
+	}
+	return false;
+}
+
+void dynamic_cube::walk()
+{
+// The selection cubealgorithm() makes at grid size t: the boundary points,
+// then the representatives in counter order that differ from every point
+// taken so far
+	dataset view = datasetView(values.data(), d, alive.size(), d, 1);
+	std::unordered_set<size_t, coordinate_hash, coordinate_equal> seen(
+		2 * (size_t)k, coordinate_hash{&view, nullptr}, coordinate_equal{&view, nullptr});
+
+	answer.clear();
+	for (size_t j = 0; j + 1 < d; ++j)
+	{
+		answer.push_back(c[j]);
+		seen.insert(c[j]);
+	}
+
+	lastCell = kNoCell;
+	auto it = cells.begin();
+	for (; it != cells.end() && answer.size() < (size_t)k; ++it)
+		if (seen.insert(it->second.best).second)
+			answer.push_back(it->second.best);
+	if (answer.size() >= (size_t)k && it != cells.begin())
+		lastCell = std::prev(it)->first;
+
+	distinct = answer.size();
+	answer.resize(k, answer[0]);
+}
+
+bool dynamic_cube::enough() const
+{
+// cube()'s stopping rule for a grid size
+	return distinct >= (size_t)k || distinct >= live || cells.size() == candidates;
+}
+
+void dynamic_cube::touched(uint64_t cell)
+{
+// A cube was created, emptied or given a new representative. The selection
+// can only change if the walk reached that cube or ran out of cubes.
+	if (lastCell == kNoCell || cell <= lastCell)
+	{
+		walk();
+		if (!enough())
+			rebuild();
+	}
+}
+
+void dynamic_cube::settle()
+{
+	if (updates >= std::max(kMinRebuildUpdates, live / 4))
+		rebuild();
+}
+
+void dynamic_cube::rebuild()
+{
+	std::vector<size_t> ids;
+	dataset points = livePoints(&ids);
+
+	rebuildCount++;
+	updates = 0;
+	cells.clear();
+	cellOfRow.assign(alive.size(), kNoCell);
+	position.assign(alive.size(), 0);
+	cellOfRow.reserve(alive.capacity());
+	position.reserve(alive.capacity());
+	candidates = 0;
+
+	// fewer live points than K (or too few dimensions): nothing to maintain,
+	// every update rebuilds
+	if (live < (size_t)k || d < 2)
+	{
+		packed = false;
+		answer = ids;
+		distinct = ids.size();
+		if (!answer.empty())
+			answer.resize(k, answer[0]);
+		return;
+	}
+
+	std::vector<int> chosen(k);
+	cube_solver(points, k, options).select(k, chosen.data(), &t);
+
+	std::vector<size_t> argmax(d);
+	columnArgMax(points, argmax.data());
+	c.resize(d);
+	for (size_t j = 0; j < d; ++j)
+		c[j] = ids[argmax[j]];
+
+	double radix = 1.0;
+	for (size_t j = 0; j + 1 < d; ++j)
+		radix *= t;
+	packed = radix < 18446744073709551615.0;
+	if (!packed)
+	{
+		answer.resize(k);
+		for (int i = 0; i < k; ++i)
+			answer[i] = ids[chosen[i]];
+		return;
+	}
+
+	uint64_t cell;
+	for (size_t id : ids)
+		add(id, cell);
+	walk();
+}
+
+size_t dynamic_cube::insert(const double* p)
+{
+	size_t id = alive.size();
+
+	values.insert(values.end(), p, p + d);
+	alive.push_back(1);
+	cellOfRow.push_back(kNoCell);
+	position.push_back(0);
+	live++;
+	updates++;
+
+	if (!packed)
+	{
+		rebuild();
+		return id;
+	}
+
+	// a new maximum in a free dimension moves every cube boundary
+	for (size_t j = 0; j + 1 < d; ++j)
+		if (p[j] > value(c[j], j))
+		{
+			rebuild();
+			return id;
+		}
+
+	uint64_t cell;
+	if (add(id, cell))
+		touched(cell);
+	else if (distinct < (size_t)k && !enough())
+		rebuild();
+	settle();
+	return id;
+}
+
+bool dynamic_cube::erase(size_t id)
+{
+	size_t L = d - 1;
+
+	if (id >= alive.size() || !alive[id])
+		return false;
+	alive[id] = 0;
+	live--;
+	updates++;
+
+	if (!packed || std::find(c.begin(), c.begin() + L, id) != c.begin() + L)
+	{
+		rebuild();
+		return true;
+	}
+
+	if (inside(id))
+		candidates--;
+
+	uint64_t cell = cellOfRow[id];
+	if (cell != kNoCell)
+	{
+		cube_cell& cube = cells[cell];
+		size_t last = cube.members.back();
+		cube.members[position[id]] = last;
+		position[last] = position[id];
+		cube.members.pop_back();
+		cellOfRow[id] = kNoCell;
+
+		if (cube.members.empty())
+		{
+			cells.erase(cell);
+			touched(cell);
+		}
+		else if (cube.best == id)
+		{
+			cube.best = cube.members[0];
+			for (size_t m : cube.members)
+				if (value(m, L) > value(cube.best, L) || (value(m, L) == value(cube.best, L) && m < cube.best))
+					cube.best = m;
+			touched(cell);
+		}
+	}
+	settle();
+	return true;
+}
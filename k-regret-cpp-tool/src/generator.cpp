@@ -0,0 +1,152 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+// Synthetic independent, correlated and anti-correlated datasets
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <random>
+#include <vector>
+
+#include <kregret/generator.h>
+#include <kregret/parallel.h>
+
+// Points drawn from one random stream; blocks make the output independent of
+// the number of threads
+static const size_t kGenerateBlock = 4096;
+
+bool parseDistribution(const std::string& name, distribution& out)
+{
+	if (name == "independent" || name == "ind")
+		out = distribution::independent;
+	else if (name == "correlated" || name == "cor")
+		out = distribution::correlated;
+	else if (name == "anticorrelated" || name == "anti")
+		out = distribution::anticorrelated;
+	else
+		return false;
+	return true;
+}
+
+const char* distributionName(distribution kind)
+{
+	switch (kind)
+	{
+	case distribution::correlated:
+		return "correlated";
+	case distribution::anticorrelated:
+		return "anticorrelated";
+	default:
+		return "independent";
+	}
+}
+
+// Mean of D uniforms on [lo, hi): peaked at the middle, more so as D grows
+static double peak(std::mt19937_64& rng, double lo, double hi, size_t D)
+{
+	std::uniform_real_distribution<double> uniform(lo, hi);
+	double sum = 0.0;
+	for (size_t j = 0; j < D; ++j)
+		sum += uniform(rng);
+	return sum / D;
+}
+
+static void generatePoint(distribution kind, std::mt19937_64& rng, size_t D, double* x)
+{
+// Draws one point into x, redrawing correlated and anti-correlated points that
+// leave the unit cube. Both start on the diagonal at v and move mass between
+// neighbouring coordinates, which keeps the coordinate sum at D * v.
+	std::uniform_real_distribution<double> uniform(0.0, 1.0);
+	std::normal_distribution<double> plane(0.5, 0.0625);
+
+	if (kind == distribution::independent)
+	{
+		for (size_t j = 0; j < D; ++j)
+			x[j] = uniform(rng);
+		return;
+	}
+
+	for (;;)
+	{
+		double v;
+		if (kind == distribution::correlated)
+			v = peak(rng, 0.0, 1.0, D);
+		else
+			do v = plane(rng); while (v < 0.0 || v > 1.0);
+		double l = std::min(v, 1.0 - v);
+
+		std::fill(x, x + D, v);
+		for (size_t j = 0; j < D; ++j)
+		{
+			double h = kind == distribution::correlated ? peak(rng, -l, l, D)
+				: std::uniform_real_distribution<double>(-l, l)(rng);
+			x[j] += h;
+			x[(j + 1) % D] -= h;
+		}
+
+		bool inside = true;
+		for (size_t j = 0; j < D; ++j)
+			inside &= x[j] >= 0.0 && x[j] <= 1.0;
+		if (inside)
+			return;
+	}
+}
+
+dataset generateDataset(distribution kind, size_t D, size_t N, uint64_t seed)
+{
+	dataset ds = allocateDataset(D, N);
+	size_t blocks = (N + kGenerateBlock - 1) / kGenerateBlock;
+
+	parallelFor(0, blocks, 1, [&](size_t lo, size_t hi, size_t) {
+		for (size_t b = lo; b < hi; ++b)
+		{
+			std::mt19937_64 rng(seed ^ (0x9E3779B97F4A7C15ULL * (b + 1)));
+			size_t end = std::min(N, (b + 1) * kGenerateBlock);
+			for (size_t i = b * kGenerateBlock; i < end; ++i)
+				generatePoint(kind, rng, D, ds.row(i));
+		}
+	});
+	return ds;
+}
+
+bool writeDatasetText(const char* path, const dataset& ds, char sep)
+{
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	if (!out)
+		return false;
+
+	// shortest round-trip form, so that parsing it gives the same doubles
+	std::vector<char> line(ds.d * 32 + 1);
+	for (size_t i = 0; i < ds.n && out; ++i)
+	{
+		char* p = line.data();
+		char* end = line.data() + line.size();
+		for (size_t j = 0; j < ds.d; ++j)
+		{
+			if (j > 0)
+				*p++ = sep;
+			p = std::to_chars(p, end, ds.value(i, j)).ptr;
+		}
+		*p++ = '\n';
+		out.write(line.data(), p - line.data());
+	}
+	out.close();
+	return !out.fail();
+}
@@ -0,0 +1,174 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+// Algorithm adding the worst-served point one at a time (RDP-Greedy)
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <kregret/greedy.h>
+#include <kregret/parallel.h>
+#include <kregret/regret.h>
+#include <kregret/skyline.h>
+
+// Per-candidate LPs are kept between rounds only while all of them together
+// stay below this many tableau entries; past it every evaluation starts cold
+static const size_t kWarmBudget = (size_t)1 << 26;
+
+struct greedy_candidate
+{
+	size_t row;
+	double bound;    // upper bound on the regret ratio against the chosen points
+	size_t solvedAt; // number of chosen points when bound was last solved exactly
+	std::unique_ptr<regret_lp> lp;
+};
+
+static void catchUp(const dataset& ds, greedy_candidate& cand, const std::vector<size_t>& chosen,
+	const double *scale, std::vector<double>& buffer)
+{
+// Adds the chosen points that cand's LP has not seen yet
+	size_t D = ds.d;
+
+	if (!cand.lp)
+	{
+		for (size_t j = 0; j < D; ++j)
+			buffer[j] = ds.value(cand.row, j);
+		cand.lp.reset(new regret_lp(buffer.data(), D, scale));
+	}
+	for (size_t s = cand.lp->constraints(); s < chosen.size(); ++s)
+	{
+		for (size_t j = 0; j < D; ++j)
+			buffer[j] = ds.value(chosen[s], j);
+		cand.lp->addConstraint(buffer.data());
+	}
+}
+
+double greedyExtend(const dataset& ds, const std::vector<size_t>& candidates, std::vector<size_t>& chosen, size_t K,
+	const greedy_progress& progress)
+{
+	size_t D = ds.d;
+	size_t i;
+	std::vector<double> scale = normalization(ds);
+	std::vector<greedy_candidate> live(candidates.size());
+	size_t applied = 0;
+	double regret = 0.0;
+
+	bool warm = candidates.size() * (K + 1) * (D + 1) <= kWarmBudget;
+
+	for (i = 0; i < candidates.size(); ++i)
+	{
+		live[i].row = candidates[i];
+		live[i].bound = 1.0;
+		live[i].solvedAt = 0;
+	}
+
+	for (;;)
+	{
+		size_t round = chosen.size();
+
+		// tighten every bound with the points chosen since the last round and
+		// drop the candidates they dominate, the chosen points included
+		parallelFor(0, live.size(), [&](size_t lo, size_t hi, size_t) {
+			for (size_t k = lo; k < hi; ++k)
+				for (size_t c = applied; c < round; ++c)
+				{
+					dataset newest = datasetView(ds.base + chosen[c] * ds.rowStride, D, 1, ds.rowStride, ds.colStride);
+					live[k].bound = std::min(live[k].bound, regretUpperBound(ds, live[k].row, newest));
+				}
+		});
+		applied = round;
+		live.erase(std::remove_if(live.begin(), live.end(),
+			[](const greedy_candidate& c) { return c.bound <= 0.0; }), live.end());
+
+		std::sort(live.begin(), live.end(), [](const greedy_candidate& a, const greedy_candidate& b) {
+			return a.bound > b.bound || (a.bound == b.bound && a.row < b.row);
+		});
+
+		// solve the most promising candidates first; a candidate whose bound is
+		// below the best ratio so far cannot be picked. Ties are still solved so
+		// that the pick does not depend on the order the workers finish in.
+		std::atomic<double> best(0.0);
+		size_t workers = std::max<size_t>(1, std::min(workerCount(), live.size()));
+		parallelFor(0, workers, [&](size_t lo, size_t hi, size_t) {
+			std::vector<double> buffer(D);
+			for (size_t w = lo; w < hi; ++w)
+				for (size_t k = w; k < live.size(); k += workers)
+				{
+					greedy_candidate& cand = live[k];
+					double current = best.load();
+					if (cand.bound < current)
+						break; // bounds are sorted, so nothing later on this stride can win
+
+					catchUp(ds, cand, chosen, scale.data(), buffer);
+					cand.bound = cand.lp->solve();
+					cand.solvedAt = round;
+					if (!warm)
+						cand.lp.reset();
+
+					double r = cand.bound;
+					while (r > current && !best.compare_exchange_weak(current, r))
+						;
+				}
+		});
+
+		regret = best.load();
+		if (progress)
+			progress(round, regret);
+		if (round >= K || regret <= 0.0)
+			break;
+
+		// the candidate with the largest ratio, lowest row on ties
+		greedy_candidate* pick = nullptr;
+		for (greedy_candidate& cand : live)
+			if (cand.solvedAt == round && (pick == nullptr || cand.bound > pick->bound
+				|| (cand.bound == pick->bound && cand.row < pick->row)))
+				pick = &cand;
+		chosen.push_back(pick->row);
+	}
+	return regret;
+}
+
+kregret_result greedy(const dataset& ds, int K, int *maxIndex, const greedy_progress& progress)
+{
+	size_t i, j;
+	std::vector<size_t> rows = skyline(ds);
+	std::vector<size_t> chosen;
+	kregret_result result;
+
+	// start from the skyline point that is best in the first dimension
+	size_t first = 0;
+	for (i = 0; i < rows.size(); ++i)
+		if (ds.value(rows[i], 0) > ds.value(rows[first], 0))
+			first = i;
+	chosen.push_back(rows[first]);
+	result.max_regret = greedyExtend(ds, rows, chosen, (size_t)K, progress);
+
+	// fill in any remaining positions with the first point found
+	for (j = 0; j < (size_t)K; ++j)
+		maxIndex[j] = (int)chosen[j < chosen.size() ? j : 0];
+
+	result.result_indices.assign(maxIndex, maxIndex + K);
+	dataset points = selectRows(ds, result.result_indices);
+	for (j = 0; j < (size_t)K; ++j)
+		result.addPoint(points.at(j));
+	result.storage = points.storage;
+	return result;
+}
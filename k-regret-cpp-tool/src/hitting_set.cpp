@@ -0,0 +1,415 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+// Algorithm hitting the eps-top sets of sampled utilities (set cover)
+#include <algorithm>
+#include <numeric>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include <kregret/greedy.h>
+#include <kregret/hitting_set.h>
+#include <kregret/parallel.h>
+#include <kregret/regret.h>
+#include <kregret/skyline.h>
+#include <kregret/utility_kernels.h>
+
+// Points of a block are scored against a block of directions this many at a time
+static const size_t kScoreRows = 64;
+// Bisection stops once the bracket on eps is this narrow
+static const double kEpsilonTolerance = 1e-6;
+// Largest ratio the first collection of top sets keeps; it grows from here
+// only as far as the cover needs
+static const double kInitialBound = 0.01;
+
+// Best score on each of the M sampled directions and the D axes. The axes
+// are directions M, ..., M + D - 1: the sampled ones seldom come near them,
+// yet that is where a few points most often fall short. With unit column
+// maxima the best score on an axis is 1, or 0 for a zero column.
+struct direction_tops
+{
+	std::vector<double> top;      // sampled directions only
+	std::vector<char> axisUsed;   // axes with a positive best score
+	size_t needed;                // directions with a positive best score; the rest
+	                              // are served by anything and never listed
+};
+
+// Every (point, direction) pair whose score ratio is within a bound, grouped
+// by point (compressed sparse rows) with the largest ratio first
+struct top_sets
+{
+	std::vector<size_t> start;    // pairs of point i are [start[i], start[i + 1])
+	std::vector<uint32_t> dir;
+	std::vector<float> ratio;     // score / best score on the direction
+	size_t directions;
+	size_t needed;
+};
+
+static direction_tops directionTops(const std::vector<double>& packed, size_t S, size_t D, size_t M, uint64_t seed)
+{
+	size_t blocks = (M + kUtilityBlock - 1) / kUtilityBlock;
+	direction_tops tops;
+
+	tops.top.resize(M);
+	parallelFor(0, blocks, [&](size_t lo, size_t hi, size_t) {
+		std::vector<double> w(D * kUtilityBlock);
+		for (size_t b = lo; b < hi; ++b)
+		{
+			size_t width = std::min(kUtilityBlock, M - b * kUtilityBlock);
+			sampleUtilities(seed, b, D, width, w.data());
+			blockMax(packed.data(), S, D, w.data(), width, &tops.top[b * kUtilityBlock]);
+		}
+	});
+
+	tops.axisUsed.assign(D, 0);
+	for (size_t i = 0; i < S; ++i)
+		for (size_t j = 0; j < D; ++j)
+			if (packed[i * D + j] > 0)
+				tops.axisUsed[j] = 1;
+	tops.needed = std::count(tops.axisUsed.begin(), tops.axisUsed.end(), 1);
+	for (size_t u = 0; u < M; ++u)
+		tops.needed += tops.top[u] > 0;
+	return tops;
+}
+
+static double setRegret(const direction_tops& tops, const std::vector<double>& packed, size_t D, size_t M, uint64_t seed,
+	const std::vector<size_t>& points)
+{
+// Regret ratio of the given packed points over the sampled directions and the axes
+	size_t blocks = (M + kUtilityBlock - 1) / kUtilityBlock;
+	std::vector<double> chosen(points.size() * D);
+	for (size_t i = 0; i < points.size(); ++i)
+		std::copy(&packed[points[i] * D], &packed[points[i] * D] + D, &chosen[i * D]);
+
+	std::vector<double> blockHigh(blocks, 0.0);
+	parallelFor(0, blocks, [&](size_t lo, size_t hi, size_t) {
+		std::vector<double> w(D * kUtilityBlock), best(kUtilityBlock);
+		for (size_t b = lo; b < hi; ++b)
+		{
+			size_t width = std::min(kUtilityBlock, M - b * kUtilityBlock);
+			sampleUtilities(seed, b, D, width, w.data());
+			blockMax(chosen.data(), points.size(), D, w.data(), width, best.data());
+			for (size_t u = 0; u < width; ++u)
+			{
+				double t = tops.top[b * kUtilityBlock + u];
+				if (t > 0)
+					blockHigh[b] = std::max(blockHigh[b], (t - best[u]) / t);
+			}
+		}
+	});
+
+	double regret = blocks ? *std::max_element(blockHigh.begin(), blockHigh.end()) : 0.0;
+	for (size_t j = 0; j < D; ++j)
+		if (tops.axisUsed[j])
+		{
+			double best = 0.0;
+			for (size_t i = 0; i < points.size(); ++i)
+				best = std::max(best, chosen[i * D + j]);
+			regret = std::max(regret, 1.0 - best);
+		}
+	return regret;
+}
+
+static top_sets topSets(const std::vector<double>& packed, size_t S, size_t D, size_t M, uint64_t seed,
+	const direction_tops& tops, double bound)
+{
+// Scores the S packed points on M sampled directions and the D axes again and
+// keeps the pairs within bound. Memory grows with the bound, so the caller
+// asks for no more than the eps it has to try.
+	size_t i, j;
+	size_t blocks = (M + kUtilityBlock - 1) / kUtilityBlock;
+	top_sets sets;
+
+	// collect the pairs per block of directions, then regroup them by point
+	struct pair_list { std::vector<uint32_t> point, dir; std::vector<float> ratio; };
+	std::vector<pair_list> found(blocks + 1);
+	parallelFor(0, blocks, [&](size_t lo, size_t hi, size_t) {
+		std::vector<double> w(D * kUtilityBlock), scores(kScoreRows * kUtilityBlock);
+		for (size_t b = lo; b < hi; ++b)
+		{
+			size_t width = std::min(kUtilityBlock, M - b * kUtilityBlock);
+			const double* best = &tops.top[b * kUtilityBlock];
+			sampleUtilities(seed, b, D, width, w.data());
+			for (size_t p0 = 0; p0 < S; p0 += kScoreRows)
+			{
+				size_t count = std::min(kScoreRows, S - p0);
+				blockScores(&packed[p0 * D], count, D, w.data(), width, scores.data());
+				for (size_t r = 0; r < count; ++r)
+					for (size_t u = 0; u < width; ++u)
+						if (best[u] > 0 && scores[r * width + u] >= (1.0 - bound) * best[u])
+						{
+							found[b].point.push_back((uint32_t)(p0 + r));
+							found[b].dir.push_back((uint32_t)(b * kUtilityBlock + u));
+							found[b].ratio.push_back((float)(scores[r * width + u] / best[u]));
+						}
+			}
+		}
+	});
+
+	for (i = 0; i < S; ++i)
+		for (j = 0; j < D; ++j)
+			if (tops.axisUsed[j] && packed[i * D + j] >= 1.0 - bound)
+			{
+				found[blocks].point.push_back((uint32_t)i);
+				found[blocks].dir.push_back((uint32_t)(M + j));
+				found[blocks].ratio.push_back((float)packed[i * D + j]);
+			}
+
+	sets.directions = M + D;
+	sets.needed = tops.needed;
+
+	sets.start.assign(S + 1, 0);
+	for (const pair_list& f : found)
+		for (uint32_t p : f.point)
+			sets.start[p + 1]++;
+	for (i = 0; i < S; ++i)
+		sets.start[i + 1] += sets.start[i];
+	sets.dir.resize(sets.start[S]);
+	sets.ratio.resize(sets.start[S]);
+	std::vector<size_t> next(sets.start.begin(), sets.start.end() - 1);
+	for (pair_list& f : found)
+	{
+		for (size_t k = 0; k < f.point.size(); ++k)
+		{
+			size_t at = next[f.point[k]]++;
+			sets.dir[at] = f.dir[k];
+			sets.ratio[at] = f.ratio[k];
+		}
+		f = pair_list();
+	}
+
+	// largest ratio first, so that a pass for a given eps stops at the threshold
+	parallelFor(0, S, [&](size_t lo, size_t hi, size_t) {
+		std::vector<size_t> order;
+		std::vector<uint32_t> dir;
+		std::vector<float> ratio;
+		for (size_t p = lo; p < hi; ++p)
+		{
+			size_t first = sets.start[p], count = sets.start[p + 1] - first;
+			order.resize(count);
+			std::iota(order.begin(), order.end(), first);
+			std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+				return sets.ratio[a] > sets.ratio[b] || (sets.ratio[a] == sets.ratio[b] && sets.dir[a] < sets.dir[b]);
+			});
+			dir.resize(count);
+			ratio.resize(count);
+			for (size_t k = 0; k < count; ++k)
+			{
+				dir[k] = sets.dir[order[k]];
+				ratio[k] = sets.ratio[order[k]];
+			}
+			std::copy(dir.begin(), dir.end(), sets.dir.begin() + first);
+			std::copy(ratio.begin(), ratio.end(), sets.ratio.begin() + first);
+		}
+	});
+
+	return sets;
+}
+
+static void cover(const top_sets& sets, double eps, size_t limit, std::vector<size_t>& picked)
+{
+// Greedy set cover of the directions by eps-top sets, keeping the points
+// already in picked and adding until every direction is covered, no point
+// helps, or picked holds limit points. Gains only shrink as directions get
+// covered, so a popped point whose refreshed gain still tops the queue is the
+// greedy choice; ties go to the lower point.
+	size_t points = sets.start.size() - 1;
+	float threshold = (float)(1.0 - eps);
+	std::vector<char> covered(sets.directions, 0);
+	size_t uncovered = sets.needed;
+
+	auto gain = [&](size_t i) {
+		size_t g = 0;
+		for (size_t k = sets.start[i]; k < sets.start[i + 1] && sets.ratio[k] >= threshold; ++k)
+			g += !covered[sets.dir[k]];
+		return g;
+	};
+	auto take = [&](size_t i) {
+		for (size_t k = sets.start[i]; k < sets.start[i + 1] && sets.ratio[k] >= threshold; ++k)
+			if (!covered[sets.dir[k]])
+			{
+				covered[sets.dir[k]] = 1;
+				uncovered--;
+			}
+	};
+
+	for (size_t i : picked)
+		take(i);
+
+	// max-heap on gain, then on the lower point index
+	typedef std::pair<size_t, size_t> entry; // (gain, ~point)
+	std::priority_queue<entry> queue;
+	for (size_t i = 0; i < points; ++i)
+	{
+		size_t g = gain(i);
+		if (g > 0)
+			queue.push(entry(g, ~i));
+	}
+
+	while (uncovered > 0 && picked.size() < limit && !queue.empty())
+	{
+		entry top = queue.top();
+		queue.pop();
+		size_t i = ~top.second;
+		size_t g = gain(i);
+		if (g == 0)
+			continue;
+		if (!queue.empty() && entry(g, ~i) < queue.top())
+		{
+			queue.push(entry(g, ~i));
+			continue;
+		}
+		picked.push_back(i);
+		take(i);
+	}
+}
+
+kregret_result hittingSet(const dataset& ds, int K, int *maxIndex, size_t directions, uint64_t seed)
+{
+	size_t D = ds.d;
+	size_t i, j;
+	std::vector<size_t> rows = skyline(ds);
+	std::vector<double> scale = normalization(ds);
+	std::vector<double> packed = packRows(ds, &rows, rows.size(), scale.data());
+	size_t S = rows.size();
+	size_t M = directions ? directions : std::max<size_t>(2048, 16 * (size_t)K);
+	std::vector<size_t> picked;
+	kregret_result result;
+
+	// the column maxima (fewer than D points when one row tops several columns)
+	// serve every direction within their sampled regret, so up to K of them
+	// bound every eps the bisection needs
+	std::vector<size_t> c(D), boundary;
+	columnArgMax(ds, c.data());
+	for (j = 0; j < D; ++j)
+	{
+		size_t at = std::lower_bound(rows.begin(), rows.end(), c[j]) - rows.begin();
+		if (at < S && rows[at] == c[j] && std::find(boundary.begin(), boundary.end(), at) == boundary.end())
+			boundary.push_back(at);
+	}
+	if (boundary.size() > (size_t)K)
+		boundary.clear();
+
+	direction_tops tops = directionTops(packed, S, D, M, seed);
+	double cap = boundary.empty() ? 1.0 : setRegret(tops, packed, D, M, seed, boundary);
+	double bound = std::min(cap, kInitialBound);
+	top_sets sets = topSets(packed, S, D, M, seed, tops, bound);
+
+	// at eps = 0 only the best point of each direction serves it; if K points
+	// manage that there is nothing to bisect
+	cover(sets, 0.0, (size_t)K + 1, picked);
+	bool spare = picked.size() <= (size_t)K;
+	if (!spare)
+	{
+		double lo = 0.0;
+		picked.clear();
+		cover(sets, bound, (size_t)K + 1, picked);
+		if (picked.size() > (size_t)K && bound < cap)
+		{
+			// the greedy cover at the small bound, cut at K points, is a cheap
+			// set whose regret also bounds eps
+			std::vector<size_t> feasible;
+			cover(sets, bound, (size_t)K, feasible);
+			double seedRegret = setRegret(tops, packed, D, M, seed, feasible);
+			if (seedRegret < cap)
+			{
+				cap = seedRegret;
+				boundary = feasible;
+			}
+
+			// widen the collection only as far as a cover of K points needs
+			while (picked.size() > (size_t)K && bound < cap)
+			{
+				lo = bound;
+				bound = std::min(2 * bound, cap);
+				sets = top_sets();
+				sets = topSets(packed, S, D, M, seed, tops, bound);
+				picked.clear();
+				cover(sets, bound, (size_t)K + 1, picked);
+			}
+		}
+
+		if (picked.size() > (size_t)K)
+		{
+			// greedy needs more than K points even at the cap: keep the set that set it
+			picked = boundary;
+			cover(sets, bound, (size_t)K, picked);
+		}
+		else
+		{
+			double hi = bound;
+			while (hi - lo > kEpsilonTolerance)
+			{
+				double mid = lo + (hi - lo) / 2;
+				picked.clear();
+				cover(sets, mid, (size_t)K + 1, picked);
+				if (picked.size() <= (size_t)K)
+					hi = mid;
+				else
+					lo = mid;
+			}
+
+			// cover at hi, then spend any slots left on the largest eps that fails
+			picked.clear();
+			cover(sets, hi, (size_t)K, picked);
+			cover(sets, lo, (size_t)K, picked);
+		}
+	}
+
+	std::vector<size_t> chosen;
+	for (size_t p : picked)
+		chosen.push_back(rows[p]);
+
+	if (spare)
+	{
+		// the sampled directions cannot tell the sets that serve them all apart:
+		// add the column maxima, then spend the slots left on the points with
+		// the largest exact regret ratio
+		for (j = 0; j < boundary.size() && chosen.size() < (size_t)K; ++j)
+			if (std::find(chosen.begin(), chosen.end(), rows[boundary[j]]) == chosen.end())
+				chosen.push_back(rows[boundary[j]]);
+		// no direction needed a point (every value is 0), so any row serves
+		if (chosen.empty())
+			chosen.push_back(c[0]);
+		greedyExtend(ds, rows, chosen, (size_t)K);
+	}
+
+	// fill in any remaining positions with the first point found
+	for (j = 0; j < (size_t)K; ++j)
+		maxIndex[j] = (int)chosen[j < chosen.size() ? j : 0];
+
+	result.result_indices.assign(maxIndex, maxIndex + K);
+	dataset points = selectRows(ds, result.result_indices);
+	for (j = 0; j < (size_t)K; ++j)
+		result.addPoint(points.at(j));
+	result.storage = points.storage;
+
+	result.max_regret = sampledMaxRegretRatio(ds, points, M, seed, 0.95, &rows).maxRegret;
+	for (j = 0; j < D; ++j)
+	{
+		double best = 0.0, overall = ds.value(c[j], j);
+		for (i = 0; i < (size_t)K; ++i)
+			best = std::max(best, points.value(i, j));
+		if (overall > 0)
+			result.max_regret = std::max(result.max_regret, (overall - best) / overall);
+	}
+	return result;
+}
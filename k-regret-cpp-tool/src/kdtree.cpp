@@ -0,0 +1,159 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+// Kd-tree for nearest point queries
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include <kregret/kdtree.h>
+#include <kregret/kernels.h>
+
+static const size_t kLeafSize = 16;
+static const size_t kNoChild = (size_t)-1;
+
+kd_tree::kd_tree(const double* points, size_t N, size_t D)
+	: d(D), coords(points, points + N * D), index(N)
+{
+	std::iota(index.begin(), index.end(), (size_t)0);
+	if (N > 0)
+		build(0, N);
+
+	// store the coordinates in tree order
+	std::vector<double> ordered(N * D);
+	for (size_t i = 0; i < N; ++i)
+		std::copy(points + index[i] * D, points + (index[i] + 1) * D, ordered.begin() + i * D);
+	coords.swap(ordered);
+
+	// bounding box of every node
+	boxes.resize(nodes.size() * 2 * D);
+	for (size_t n = 0; n < nodes.size(); ++n)
+	{
+		double* lo = &boxes[n * 2 * D];
+		double* hi = lo + D;
+		std::fill(lo, lo + D, std::numeric_limits<double>::infinity());
+		std::fill(hi, hi + D, -std::numeric_limits<double>::infinity());
+		for (size_t i = nodes[n].begin; i < nodes[n].end; ++i)
+			for (size_t j = 0; j < D; ++j)
+			{
+				lo[j] = std::min(lo[j], coords[i * D + j]);
+				hi[j] = std::max(hi[j], coords[i * D + j]);
+			}
+	}
+}
+
+size_t kd_tree::build(size_t begin, size_t end)
+{
+// Builds the subtree over index[begin, end) and returns its node; coords
+// still holds the points in their original order at this stage
+	size_t n = nodes.size();
+	nodes.push_back({begin, end, kNoChild, kNoChild});
+	if (end - begin <= kLeafSize)
+		return n;
+
+	// split the dimension with the largest spread at its median
+	size_t dim = 0;
+	double spread = -1.0;
+	for (size_t j = 0; j < d; ++j)
+	{
+		double lo = std::numeric_limits<double>::infinity(), hi = -lo;
+		for (size_t i = begin; i < end; ++i)
+		{
+			double v = coords[index[i] * d + j];
+			lo = std::min(lo, v);
+			hi = std::max(hi, v);
+		}
+		if (hi - lo > spread)
+		{
+			spread = hi - lo;
+			dim = j;
+		}
+	}
+	if (spread <= 0.0)
+		return n; // all points identical: keep them in one leaf
+
+	size_t mid = begin + (end - begin) / 2;
+	std::nth_element(index.begin() + begin, index.begin() + mid, index.begin() + end, [&](size_t a, size_t b) {
+		double va = coords[a * d + dim], vb = coords[b * d + dim];
+		return va < vb || (va == vb && a < b);
+	});
+
+	size_t left = build(begin, mid);
+	size_t right = build(mid, end);
+	nodes[n].left = left;
+	nodes[n].right = right;
+	return n;
+}
+
+double kd_tree::boxDistance(size_t n, const double* q) const
+{
+// Squared distance from q to the bounding box of node n
+	const double* lo = &boxes[n * 2 * d];
+	const double* hi = lo + d;
+	double dist = 0.0;
+
+	for (size_t j = 0; j < d; ++j)
+	{
+		double diff = q[j] < lo[j] ? lo[j] - q[j] : (q[j] > hi[j] ? q[j] - hi[j] : 0.0);
+		dist += diff * diff;
+	}
+	return dist;
+}
+
+void kd_tree::search(size_t n, const double* q, size_t& best, double& bestDistance) const
+{
+	const node& nd = nodes[n];
+
+	if (nd.left == kNoChild)
+	{
+		dispatchDimension(d, [&](auto fd) {
+			for (size_t i = nd.begin; i < nd.end; ++i)
+			{
+				double dist = distanceKernel<decltype(fd)::value>(&coords[i * d], q, bestDistance, d);
+				if (dist < bestDistance || (dist == bestDistance && index[i] < best))
+				{
+					bestDistance = dist;
+					best = index[i];
+				}
+			}
+		});
+		return;
+	}
+
+	// descend into the nearer box first; a box can only hold a nearer point if
+	// it is within the best distance
+	double dl = boxDistance(nd.left, q), dr = boxDistance(nd.right, q);
+	size_t nearSide = dl <= dr ? nd.left : nd.right;
+	size_t farSide = dl <= dr ? nd.right : nd.left;
+	if (std::min(dl, dr) <= bestDistance)
+		search(nearSide, q, best, bestDistance);
+	if (std::max(dl, dr) <= bestDistance)
+		search(farSide, q, best, bestDistance);
+}
+
+size_t kd_tree::nearest(const double* q) const
+{
+	size_t best = (size_t)-1;
+	double bestDistance = std::numeric_limits<double>::infinity();
+
+	if (!nodes.empty())
+		search(0, q, best, bestDistance);
+	return best;
+}
@@ -17,32 +17,44 @@
 //along with this program. If not, see <http://www.gnu.org/licenses/>.
 //==========================================================================================
 
+#include <algorithm>
+#include <limits>
+
 #include <kregret/kregret_result.h>
+#include <kregret/parallel.h>
+#include <kregret/regret.h>
+
+void kregret_result::addPoint(point p) {
+    this->result_points.push_back(p);
+}
 
 void kregret_result::calculateMaxRegretRatio(size_t N,struct point* p) {
     double maxRegret = 0.0;
     size_t D = this->result_points[0].d;
-    // Check axis-aligned utilities
-    for (int d = 0; d < D; d++) {
-        double* w = new double[D];
-        for (int j = 0; j < D; j++) {
-            w[j] = (j == d) ? 1.0 : 0.0;
+
+    // The best overall score of an axis-aligned utility is the column maximum,
+    // so one pass finds all D of them, with partial maxima per worker
+    std::vector<double> partial(workerCount() * D, -std::numeric_limits<double>::infinity());
+    parallelFor(0, N, [&](size_t lo, size_t hi, size_t worker) {
+        double* top = &partial[worker * D];
+        for (size_t i = lo; i < hi; i++) {
+            for (size_t d = 0; d < D; d++) {
+                top[d] = std::max(top[d], p[i].a[d]);
+            }
         }
+    });
 
-        // Find maximum utility among ALL points
+    // Check axis-aligned utilities
+    for (size_t d = 0; d < D; d++) {
         double maxUtilityOverall = -std::numeric_limits<double>::infinity();
-        for (int i = 0; i < N; i++) {
-            double utility = dot(p[i], w);
-            if (utility > maxUtilityOverall) {
-                maxUtilityOverall = utility;
-            }
+        for (size_t w = 0; w < workerCount(); w++) {
+            maxUtilityOverall = std::max(maxUtilityOverall, partial[w * D + d]);
         }
 
         // Find maximum utility in the result set
         double maxUtilityInSet = -std::numeric_limits<double>::infinity();
-        for (int j = 0; j < this->result_points.size(); j++) {
-            double utility = dot(this->result_points[j], w);
-            maxUtilityInSet = std::max(maxUtilityInSet, utility);
+        for (size_t j = 0; j < this->result_points.size(); j++) {
+            maxUtilityInSet = std::max(maxUtilityInSet, this->result_points[j].a[d]);
         }
 
         // Calculate regret for this utility vector
@@ -50,9 +62,44 @@ void kregret_result::calculateMaxRegretRatio(size_t N,struct point* p) {
             double regret = (maxUtilityOverall - maxUtilityInSet) / maxUtilityOverall;
             maxRegret = std::max(maxRegret, regret);
         }
+    }
+
+    this->max_regret = maxRegret;
+}
+
+void kregret_result::calculateMaxRegretRatio(const dataset& ds) {
+    double maxRegret = 0.0;
+    size_t D = ds.d;
+    std::vector<size_t> argmax(D);
+
+    // For an axis-aligned utility the best overall point is the column maximum
+    columnArgMax(ds, argmax.data());
 
-        delete[] w;
+    for (size_t d = 0; d < D; d++) {
+        double maxUtilityOverall = ds.value(argmax[d], d);
+
+        // Find maximum utility in the result set
+        double maxUtilityInSet = -std::numeric_limits<double>::infinity();
+        for (size_t j = 0; j < this->result_points.size(); j++) {
+            maxUtilityInSet = std::max(maxUtilityInSet, this->result_points[j].a[d]);
+        }
+
+        // Calculate regret for this utility vector
+        if (maxUtilityOverall > 0) {
+            double regret = (maxUtilityOverall - maxUtilityInSet) / maxUtilityOverall;
+            maxRegret = std::max(maxRegret, regret);
+        }
     }
 
     this->max_regret = maxRegret;
 }
+
+void kregret_result::calculateExactMaxRegretRatio(const dataset& ds) {
+    dataset selected = datasetFromPoints(this->result_points.data(), ds.d, this->result_points.size());
+    this->max_regret = exactMaxRegretRatio(ds, selected);
+}
+
+void kregret_result::calculateSampledMaxRegretRatio(const dataset& ds, size_t samples, uint64_t seed) {
+    dataset selected = datasetFromPoints(this->result_points.data(), ds.d, this->result_points.size());
+    this->max_regret = sampledMaxRegretRatio(ds, selected, samples, seed).maxRegret;
+}
@@ -0,0 +1,109 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#include <kregret/mapped_file.h>
+
+#include <cstdint>
+
+#if defined(_WIN32)
+#include <fstream>
+#include <vector>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+
+mapped_file mapFile(const char* filename)
+{
+	mapped_file file;
+	std::ifstream in(filename, std::ios::binary | std::ios::ate);
+	if (!in.is_open())
+		return file;
+
+	auto buffer = std::make_shared<std::vector<char>>((size_t)in.tellg());
+	in.seekg(0);
+	in.read(buffer->data(), buffer->size());
+
+	file.data = buffer->data();
+	file.size = buffer->size();
+	file.handle = buffer;
+	return file;
+}
+
+void releasePages(const mapped_file&, const char*, const char*)
+{
+}
+
+#else
+
+mapped_file mapFile(const char* filename)
+{
+	mapped_file file;
+	struct stat st;
+	int fd = open(filename, O_RDONLY);
+	if (fd < 0)
+		return file;
+
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+	{
+		close(fd);
+		return file;
+	}
+
+	size_t size = (size_t)st.st_size;
+	if (size == 0)
+	{
+		// mmap rejects empty mappings; an empty file is still a valid open file
+		close(fd);
+		file.handle = std::make_shared<char>(0);
+		return file;
+	}
+
+	void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED)
+		return file;
+
+#if defined(MADV_SEQUENTIAL)
+	madvise(addr, size, MADV_SEQUENTIAL);
+#endif
+
+	file.data = static_cast<const char*>(addr);
+	file.size = size;
+	file.handle = std::shared_ptr<void>(addr, [size](void* p) { munmap(p, size); });
+	return file;
+}
+
+void releasePages(const mapped_file& file, const char* begin, const char* end)
+{
+	uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+	uintptr_t lo = ((uintptr_t)begin + page - 1) / page * page;
+	uintptr_t hi = (uintptr_t)end / page * page;
+
+	if (file.size == 0 || lo >= hi)
+		return;
+	madvise((void*)lo, hi - lo, MADV_DONTNEED);
+}
+
+#endif
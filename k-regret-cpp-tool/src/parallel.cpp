@@ -0,0 +1,74 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#include <kregret/parallel.h>
+#include <kregret/thread_pool.h>
+
+#include <memory>
+#include <mutex>
+#include <thread>
+
+static std::mutex poolLock;
+static std::unique_ptr<thread_pool> pool;
+static size_t configured = 0;
+
+size_t workerCount()
+{
+	std::lock_guard<std::mutex> guard(poolLock);
+	if (configured > 0)
+		return configured;
+	size_t n = std::thread::hardware_concurrency();
+	return n > 0 ? n : 1;
+}
+
+void setWorkerCount(size_t n)
+{
+	std::lock_guard<std::mutex> guard(poolLock);
+	if (n != configured)
+	{
+		configured = n;
+		pool.reset();
+	}
+}
+
+static thread_pool& sharedPool()
+{
+	size_t n = workerCount();
+	std::lock_guard<std::mutex> guard(poolLock);
+	if (!pool || pool->size() != n)
+		pool.reset(new thread_pool(n));
+	return *pool;
+}
+
+void parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t, size_t)>& body)
+{
+	if (end <= begin)
+		return;
+	sharedPool().run(begin, end, grain, body);
+}
+
+void parallelFor(size_t begin, size_t end, const std::function<void(size_t, size_t, size_t)>& body)
+{
+	if (end <= begin)
+		return;
+	thread_pool& p = sharedPool();
+	size_t chunks = 4 * p.size();
+	p.run(begin, end, (end - begin + chunks - 1) / chunks, body);
+}
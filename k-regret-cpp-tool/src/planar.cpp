@@ -0,0 +1,398 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+// Exact selection for two-dimensional data
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <kregret/dataset_stats.h>
+#include <kregret/parallel.h>
+#include <kregret/planar.h>
+
+// Rows per x bucket of the pruning pass, and a cap on the buckets
+static const size_t kBucketRows = 16;
+static const size_t kMaxBuckets = 1 << 16;
+// The search stops once the bracket on eps is this tight, relative to eps
+static const double kTolerance = 1e-12;
+static const int kMaxSteps = 200;
+
+static void upperHull(const double* x, const double* y, const std::vector<size_t>& points,
+	std::vector<size_t>& vertices, std::vector<double>& breaks)
+{
+// The upper-right convex hull of points given with x decreasing and y
+// increasing, and the direction t at which each two consecutive vertices tie
+	vertices.clear();
+	for (size_t c : points)
+	{
+		// drop the last vertex while it lies on or below the segment to the new point
+		while (vertices.size() >= 2)
+		{
+			size_t a = vertices[vertices.size() - 2], b = vertices.back();
+			if ((x[b] - x[a]) * (y[c] - y[b]) - (y[b] - y[a]) * (x[c] - x[b]) > 0)
+				break;
+			vertices.pop_back();
+		}
+		vertices.push_back(c);
+	}
+
+	breaks.resize(vertices.size() - 1);
+	for (size_t k = 0; k + 1 < vertices.size(); ++k)
+	{
+		double dx = x[vertices[k]] - x[vertices[k + 1]], dy = y[vertices[k]] - y[vertices[k + 1]];
+		breaks[k] = dx / (dx - dy);
+	}
+}
+
+planar_solver::planar_solver(const dataset& ds)
+{
+	size_t N = ds.n;
+	size_t i, p;
+
+	// Bucket the rows by x. A row whose y does not beat the largest y in a
+	// bucket of larger x is dominated, which leaves little more than the
+	// skyline for the sort, whatever the shape of the data.
+	const dataset_stats stats = ds.stats && ds.stats->covers(ds) ? *ds.stats : computeStats(ds);
+	double low = stats.min[0], range = stats.max[0] - stats.min[0];
+	size_t buckets = std::isfinite(range) && range > 0 ? std::max<size_t>(1, std::min(N / kBucketRows, kMaxBuckets)) : 1;
+	auto bucket = [&](double v) {
+		return buckets == 1 ? 0 : std::min(buckets - 1, (size_t)((v - low) / range * buckets));
+	};
+
+	size_t workers = workerCount();
+	std::vector<double> top(workers * buckets, -std::numeric_limits<double>::infinity());
+	parallelFor(0, N, [&](size_t lo, size_t hi, size_t w) {
+		double* t = &top[w * buckets];
+		for (size_t i = lo; i < hi; ++i)
+		{
+			size_t b = bucket(ds.value(i, 0));
+			t[b] = std::max(t[b], ds.value(i, 1));
+		}
+	});
+	// above[b]: the largest y in the buckets after b
+	std::vector<double> above(buckets, -std::numeric_limits<double>::infinity());
+	for (size_t b = buckets - 1; b > 0; --b)
+	{
+		double t = above[b];
+		for (size_t w = 0; w < workers; ++w)
+			t = std::max(t, top[w * buckets + b]);
+		above[b - 1] = t;
+	}
+
+	std::vector<char> keep(N);
+	parallelFor(0, N, [&](size_t lo, size_t hi, size_t) {
+		for (size_t i = lo; i < hi; ++i)
+			keep[i] = ds.value(i, 1) > above[bucket(ds.value(i, 0))];
+	});
+	std::vector<size_t> survivors;
+	for (i = 0; i < N; ++i)
+		if (keep[i])
+			survivors.push_back(i);
+
+	// x decreasing, then y decreasing, then row: a point is on the skyline when
+	// its y beats every point before it, and of equal points the lowest row stays
+	std::sort(survivors.begin(), survivors.end(), [&](size_t a, size_t b) {
+		double xa = ds.value(a, 0), xb = ds.value(b, 0);
+		if (xa != xb)
+			return xa > xb;
+		double ya = ds.value(a, 1), yb = ds.value(b, 1);
+		if (ya != yb)
+			return ya > yb;
+		return a < b;
+	});
+	for (size_t r : survivors)
+		if (rows.empty() || ds.value(r, 1) > y.back())
+		{
+			x.push_back(ds.value(r, 0));
+			y.push_back(ds.value(r, 1));
+			rows.push_back(r);
+		}
+
+	std::vector<size_t> all(x.size());
+	for (i = 0; i < all.size(); ++i)
+		all[i] = i;
+	upperHull(x.data(), y.data(), all, hull, breaks);
+
+	// the searches compare against the best score at the range ends, kept
+	// together so they do not go through hull for every probe
+	corners.resize(hull.size() + 1);
+	for (p = 0; p <= hull.size(); ++p)
+	{
+		double t = p == 0 ? 0.0 : p == hull.size() ? 1.0 : breaks[p - 1];
+		size_t v = hull[p == hull.size() ? p - 1 : p];
+		corners[p] = { t, (1 - t) * x[v] + t * y[v] };
+	}
+
+	owner.resize(x.size());
+	for (i = 0, p = 0; i < x.size(); ++i)
+	{
+		if (p + 1 < hull.size() && hull[p + 1] == i)
+			p++;
+		owner[i] = p;
+	}
+}
+
+double planar_solver::ratio(size_t s, size_t i) const
+{
+// Score of skyline point s over the best score at corner i
+	double t = corners[i].t;
+	return ((1 - t) * x[s] + t * y[s]) / corners[i].best;
+}
+
+template <typename Pred>
+static size_t firstTrue(size_t lo, size_t hi, size_t hint, Pred pred)
+{
+// The first k in [lo, hi] with pred(k), for pred false and then true and
+// pred(hi) taken as true. Gallops outward from hint, so an answer near the
+// hint costs a few probes.
+	hint = std::min(hi, std::max(lo, hint));
+	if (hint == hi || pred(hint))
+	{
+		hi = hint;
+		for (size_t step = 1; lo < hi; step *= 2)
+		{
+			size_t k = hi - std::min(step, hi - lo);
+			if (!pred(k))
+			{
+				lo = k + 1;
+				break;
+			}
+			hi = k;
+		}
+	}
+	else
+	{
+		lo = hint + 1;
+		for (size_t step = 1; lo < hi; step *= 2)
+		{
+			size_t k = std::min(hi - 1, lo + step - 1);
+			if (pred(k))
+			{
+				hi = k;
+				break;
+			}
+			lo = k + 1;
+		}
+	}
+	while (lo < hi)
+	{
+		size_t mid = lo + (hi - lo) / 2;
+		if (pred(mid))
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+	return lo;
+}
+
+planar_solver::span planar_solver::interval(size_t s, double c, size_t hint[2]) const
+{
+// The directions where s scores at least c times the best. Its ratio to the
+// best rises up to the end of the range of its hull vertex j (for a vertex,
+// holds at 1 across that range) and falls after it; within one range the
+// ratio is monotone, so each end is a search over the ranges and one
+// linear equation. hint holds the ranges found at the last c and is updated.
+	size_t m = hull.size();
+	size_t j = owner[s];
+	bool vertex = hull[j] == s;
+	span out = { 1.0, 0.0 };
+	if (!vertex && ratio(s, j + 1) < c)
+		return out;
+
+	auto crossing = [&](size_t k) {
+		// (1 - t) * (x_s - c * x_v) + t * (y_s - c * y_v) = 0
+		double a = x[s] - c * x[hull[k]], b = y[s] - c * y[hull[k]];
+		return std::min(end(k), std::max(start(k), a / (a - b)));
+	};
+
+	// left: the first range whose end reaches c; last means none before j's own
+	size_t last = vertex ? j : j + 1;
+	size_t k = hint[0] = firstTrue(0, last, hint[0], [&](size_t i) { return ratio(s, i + 1) >= c; });
+	if (k == last)
+		out.lo = start(j);
+	else
+		out.lo = ratio(s, k) >= c ? start(k) : crossing(k);
+
+	// right: the last range after j whose start still reaches c; j means none
+	hint[1] = firstTrue(j + 1, m, hint[1], [&](size_t i) { return ratio(s, i) < c; });
+	k = hint[1] - 1;
+	if (k == j)
+		out.hi = end(j);
+	else
+		out.hi = ratio(s, k + 1) >= c ? end(k) : crossing(k);
+	return out;
+}
+
+bool planar_solver::cover(double eps, int K, std::vector<size_t>& chosen, std::vector<size_t>& hints) const
+{
+// Covers [0, 1] with the intervals at eps: from the covered prefix, always
+// take the interval starting inside it that reaches furthest. Fails if that
+// needs more than K intervals. hints carries two search hints per point
+// from one call to the next.
+	size_t n = x.size();
+	double c = 1.0 - eps;
+	std::vector<span> spans(n);
+	parallelFor(0, n, [&](size_t lo, size_t hi, size_t) {
+		for (size_t s = lo; s < hi; ++s)
+			spans[s] = interval(s, c, &hints[2 * s]);
+	});
+
+	// Two skyline points cross in ratio at most once, so in skyline order
+	// either both ends of their intervals are in order or one interval holds
+	// the other. Dropping held intervals leaves both ends increasing.
+	std::vector<size_t> order;
+	for (size_t s = 0; s < n; ++s)
+	{
+		if (spans[s].lo > spans[s].hi)
+			continue;
+		while (!order.empty() && spans[s].lo <= spans[order.back()].lo && spans[s].hi >= spans[order.back()].hi)
+			order.pop_back();
+		if (order.empty() || spans[s].lo < spans[order.back()].lo || spans[s].hi > spans[order.back()].hi)
+			order.push_back(s);
+	}
+
+	chosen.clear();
+	double covered = 0.0;
+	size_t next = 0;
+	while (chosen.empty() || covered < 1.0)
+	{
+		if (chosen.size() == (size_t)K)
+			return false;
+		size_t pick = n;
+		double reach = chosen.empty() ? -1.0 : covered;
+		for (; next < order.size() && spans[order[next]].lo <= covered; ++next)
+			if (spans[order[next]].hi > reach)
+			{
+				reach = spans[order[next]].hi;
+				pick = order[next];
+			}
+		if (pick == n)
+			return false;
+		chosen.push_back(pick);
+		covered = reach;
+	}
+	std::sort(chosen.begin(), chosen.end());
+	return true;
+}
+
+double planar_solver::regret(const std::vector<size_t>& chosen) const
+{
+// Both the best score and the best chosen score are piecewise linear in t,
+// so their ratio is monotone between the breaks of either and the largest
+// regret is found at one of them
+	std::vector<size_t> envelope;
+	std::vector<double> bends;
+	upperHull(x.data(), y.data(), chosen, envelope, bends);
+
+	double worst = 0.0;
+	size_t k = 0, w = 0;
+	auto at = [&](double t) {
+		double all = (1 - t) * x[hull[k]] + t * y[hull[k]];
+		double mine = (1 - t) * x[envelope[w]] + t * y[envelope[w]];
+		if (all > 0)
+			worst = std::max(worst, 1 - mine / all);
+	};
+	// walk the breaks of both in order, between the ends of [0, 1]
+	at(0.0);
+	while (k < breaks.size() || w < bends.size())
+	{
+		double t = std::min(k < breaks.size() ? breaks[k] : 1.0, w < bends.size() ? bends[w] : 1.0);
+		at(t);
+		if (k < breaks.size() && breaks[k] == t)
+			k++;
+		if (w < bends.size() && bends[w] == t)
+			w++;
+	}
+	at(1.0);
+	return worst;
+}
+
+double planar_solver::select(int K, int *maxIndex) const
+{
+	std::vector<size_t> chosen;
+	double found;
+	if (hull.size() <= (size_t)K)
+	{
+		// the hull vertices attain the best score in every direction
+		chosen = hull;
+		found = regret(chosen);
+	}
+	else
+	{
+		// the searches start from each point's own hull vertex, and then from
+		// wherever they ended in the last step
+		std::vector<size_t> hints(2 * x.size());
+		for (size_t s = 0; s < x.size(); ++s)
+		{
+			hints[2 * s] = owner[s];
+			hints[2 * s + 1] = owner[s] + 1;
+		}
+
+		// at eps = 1 any one point covers every direction
+		if (!cover(1.0, 1, chosen, hints))
+			chosen.assign(1, hull[0]);
+		found = regret(chosen);
+
+		// eps = 0 needs every hull vertex, more than K
+		double lo = 0.0, hi = found;
+		std::vector<size_t> trial;
+		for (int step = 0; step < kMaxSteps && hi - lo > kTolerance * hi; ++step)
+		{
+			double mid = lo + (hi - lo) / 2;
+			if (!cover(mid, K, trial, hints))
+			{
+				lo = mid;
+				continue;
+			}
+			double r = regret(trial);
+			hi = std::min(mid, r);
+			if (r <= found)
+			{
+				found = r;
+				chosen.swap(trial);
+			}
+		}
+	}
+
+	for (size_t j = 0; j < (size_t)K; ++j)
+		maxIndex[j] = (int)rows[chosen[j < chosen.size() ? j : 0]];
+	return found;
+}
+
+bool planarApplies(const dataset& ds)
+{
+	if (ds.d != 2 || ds.n == 0)
+		return false;
+	const dataset_stats stats = ds.stats && ds.stats->covers(ds) ? *ds.stats : computeStats(ds);
+	return stats.min[0] >= 0 && stats.min[1] >= 0;
+}
+
+kregret_result planar(const dataset& ds, int K, int *maxIndex)
+{
+	kregret_result result;
+	result.max_regret = planar_solver(ds).select(K, maxIndex);
+
+	result.result_indices.assign(maxIndex, maxIndex + K);
+	dataset points = selectRows(ds, result.result_indices);
+	for (size_t j = 0; j < (size_t)K; ++j)
+		result.addPoint(points.at(j));
+	result.storage = points.storage;
+	return result;
+}
@@ -17,7 +17,9 @@
 //along with this program. If not, see <http://www.gnu.org/licenses/>.
 //==========================================================================================
 
+#include <kregret/kernels.h>
 #include <kregret/point.h>
+#include <kregret/stats.h>
 
 #include <iostream>
 #include <stdio.h>
@@ -27,6 +29,7 @@ using namespace std;
 
 point* pointArray(std::vector<std::vector<double>> data, size_t D, size_t N) 
 {
+	stat_timer timer(stat_phase::convert);
 	// Convert to point array
 	struct point* points = new struct point[N];
 	for (int i = 0; i < N; i++) {
@@ -49,13 +52,9 @@ double dot(struct point p, double* w)
 // Returns the dot product of vector p and w.
 // p is the data point
 // w is the tuple representing a utilify function
-	double product = 0.0;
-	int i;
-
-	for(i = 0; i < p.d; ++i)
-		product += p.a[i] * w[i];
-
-	return product;
+	return dispatchDimension(p.d, [&](auto fd) {
+		return dotKernel<decltype(fd)::value>(p.a, w, p.d);
+	});
 }
 
 
@@ -100,15 +99,12 @@ int pointcmp(const void *a, const void *b)
 // 		p1(1,2,3,4,6) and p2(1,2,3,5,5)
 // 		=> p1 < p2 because p1[i] = p2[i] for 1 <= i <= 3
 // 		               and p1[4] < p2[4]
-	int i;
-
-	for(i = 0; i < ((struct point*)a)->d; ++i)
-	{
-		if (((struct point*)a)->a[i] < ((struct point*)b)->a[i]) return -1;
-		if (((struct point*)a)->a[i] > ((struct point*)b)->a[i]) return 1;
-	}
+	const struct point* pa = (const struct point*)a;
+	const struct point* pb = (const struct point*)b;
 
-	return 0;
+	return dispatchDimension(pa->d, [&](auto fd) {
+		return compareKernel<decltype(fd)::value>(pa->a, pb->a, pa->d);
+	});
 }
 
 
@@ -116,13 +112,9 @@ int dominates(struct point p1, struct point p2)
 {
 // Checks if p1 dominates p2
 // p1 dominates p2 when p1[i] >= p2[i] for all 1 <= i <= d
-	int i;
-
-	for(i = 0; i < p1.d; ++i)
-		if (p1.a[i] < p2.a[i])
-			return 0;
-
-	return 1;
+	return dispatchDimension(p1.d, [&](auto fd) {
+		return (int)dominatesKernel<decltype(fd)::value>(p1.a, 1, p2.a, p1.d);
+	});
 }
 
 
@@ -0,0 +1,457 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+// Query server keeping datasets resident between k-regret queries
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <future>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define KREGRET_HAVE_UNIX_SOCKETS 1
+#endif
+
+#include <kregret/greedy.h>
+#include <kregret/hitting_set.h>
+#include <kregret/planar.h>
+#include <kregret/query_server.h>
+#include <kregret/regret.h>
+#include <kregret/skyline.h>
+#include <kregret/solver.h>
+#include <kregret/sphere.h>
+
+struct served_selection
+{
+	std::vector<int> indices;
+	double exact; // exact maximum regret ratio if the engine knows it, else -1
+};
+
+struct query_server::served_dataset
+{
+	dataset points;
+
+	// computed on first use
+	std::once_flag skylineOnce, argmaxOnce, samplerOnce;
+	std::vector<size_t> sky;
+	std::vector<size_t> argmax;
+	std::unique_ptr<regret_sampler> sampler;
+
+	std::mutex lock; // guards the two caches
+	std::map<std::pair<long long, std::string>, std::shared_future<served_selection>> selections;
+	std::map<std::tuple<long long, std::string, std::string>, std::shared_future<double>> regrets;
+};
+
+template <class Map, class Compute>
+static auto memo(std::mutex& lock, Map& cache, const typename Map::key_type& key, Compute compute, bool& hit)
+	-> decltype(compute())
+{
+// Looks key up in cache, computing it if it is missing. A caller that finds
+// the entry still being computed waits for it instead of starting again.
+	typedef decltype(compute()) value;
+	std::promise<value> promise;
+	std::shared_future<value> future;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		auto it = cache.find(key);
+		hit = it != cache.end();
+		if (hit)
+			future = it->second;
+		else
+			cache.emplace(key, future = promise.get_future().share());
+	}
+
+	if (!hit)
+	{
+		try
+		{
+			promise.set_value(compute());
+		}
+		catch (...)
+		{
+			// waiters see the failure; the next query tries again
+			promise.set_exception(std::current_exception());
+			std::lock_guard<std::mutex> guard(lock);
+			cache.erase(key);
+		}
+	}
+	return future.get();
+}
+
+static bool parseSeparator(const std::string& arg, char& sep)
+{
+	if (arg.size() == 1)
+		sep = arg[0];
+	else if (arg == "\\t")
+		sep = '\t';
+	else if (arg == "\\s")
+		sep = ' ';
+	else
+		return false;
+	return true;
+}
+
+query_server::query_server(const server_settings& s)
+	: settings(s), stopping(false), listener(-1)
+{
+}
+
+bool query_server::load(const std::string& name, const std::string& path, char sep, std::string& error)
+{
+	auto served = std::make_shared<served_dataset>();
+	dataset& points = served->points;
+
+	switch (loadDataset(path.c_str(), sep, points, settings.useCache, settings.verifyCache))
+	{
+	case solver_status::ok:
+		break;
+	case solver_status::cannot_open:
+		error = "Cannot open file " + path;
+		return false;
+	case solver_status::no_data:
+		error = "No valid data found in file " + path;
+		return false;
+	default:
+		error = "Cannot load file " + path;
+		return false;
+	}
+
+	if (points.d <= 1)
+	{
+		error = "Number of Dimensions must be at least 2";
+		return false;
+	}
+
+	std::lock_guard<std::mutex> guard(lock);
+	datasets[name] = served;
+	return true;
+}
+
+std::shared_ptr<query_server::served_dataset> query_server::find(const std::string& name)
+{
+	std::lock_guard<std::mutex> guard(lock);
+	auto it = datasets.find(name);
+	return it == datasets.end() ? nullptr : it->second;
+}
+
+std::string query_server::query(const std::string& name, long long K, const std::string& engine, const std::string& evaluator)
+{
+	std::shared_ptr<served_dataset> served = find(name);
+	if (!served)
+		return "error unknown dataset '" + name + "'";
+	const dataset& points = served->points;
+
+	if (K <= 0 || (unsigned long long)K > points.n || K > std::numeric_limits<int>::max())
+		return "error k must be between 1 and " + std::to_string(points.n);
+	if (engine != "cube" && engine != "greedy" && engine != "sphere" && engine != "hs")
+		return "error unknown engine '" + engine + "' (expected cube, greedy, sphere or hs)";
+	if (evaluator != "axis" && evaluator != "exact" && evaluator != "sampled")
+		return "error unknown evaluator '" + evaluator + "' (expected axis, exact or sampled)";
+
+	auto start = std::chrono::steady_clock::now();
+	bool selectionHit, regretHit;
+
+	const served_selection chosen = memo(served->lock, served->selections, std::make_pair(K, engine), [&]() {
+		served_selection s;
+		s.indices.resize(K);
+		s.exact = -1.0;
+		if (engine == "greedy")
+			s.exact = greedy(points, (int)K, s.indices.data()).max_regret;
+		else if (engine == "sphere")
+			sphere(points, (int)K, s.indices.data());
+		else if (engine == "hs")
+			hittingSet(points, (int)K, s.indices.data(), settings.hsDirections, settings.seed);
+		else if (planarApplies(points))
+			s.exact = planar(points, (int)K, s.indices.data()).max_regret;
+		else
+			cube(points, (int)K, s.indices.data(), settings.options);
+		return s;
+	}, selectionHit);
+
+	double regret = memo(served->lock, served->regrets, std::make_tuple(K, engine, evaluator), [&]() {
+		std::vector<size_t> rows(chosen.indices.begin(), chosen.indices.end());
+
+		if (evaluator == "axis")
+		{
+			std::call_once(served->argmaxOnce, [&]() {
+				served->argmax.resize(points.d);
+				columnArgMax(points, served->argmax.data());
+			});
+			return axisMaxRegretRatio(points, served->argmax.data(), rows);
+		}
+
+		if (evaluator == "exact" && chosen.exact >= 0.0)
+			return chosen.exact;
+
+		std::call_once(served->skylineOnce, [&]() { served->sky = skyline(points); });
+		if (evaluator == "exact")
+			return exactMaxRegretRatio(points, selectRows(points, rows), &served->sky);
+
+		std::call_once(served->samplerOnce, [&]() {
+			served->sampler.reset(new regret_sampler(points, settings.samples, settings.seed, 0.95, &served->sky));
+		});
+		return served->sampler->evaluate(selectRows(points, rows)).maxRegret;
+	}, regretHit);
+
+	long long elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+	std::ostringstream reply;
+	reply.precision(6);
+	reply << "ok k=" << K << " regret=" << std::fixed << regret << " cached=" << (regretHit ? 1 : 0)
+		<< " time_us=" << elapsed << " indices=";
+	for (size_t i = 0; i < chosen.indices.size(); ++i)
+		reply << (i ? "," : "") << chosen.indices[i];
+	return reply.str();
+}
+
+std::string query_server::handle(const std::string& line)
+{
+	std::istringstream in(line);
+	std::vector<std::string> words;
+	std::string word;
+	while (in >> word)
+		words.push_back(word);
+
+	if (words.empty())
+		return "error empty request";
+
+	try
+	{
+		const std::string& command = words[0];
+		if (command == "ping" && words.size() == 1)
+			return "ok";
+
+		if (command == "load" && (words.size() == 3 || words.size() == 4))
+		{
+			char sep = ',';
+			std::string error;
+			if (words.size() == 4 && !parseSeparator(words[3], sep))
+				return "error separator must be a single character or escape sequence (\\t \\s)";
+			if (!load(words[1], words[2], sep, error))
+				return "error " + error;
+			std::shared_ptr<served_dataset> served = find(words[1]);
+			return "ok name=" + words[1] + " n=" + std::to_string(served->points.n) + " d=" + std::to_string(served->points.d);
+		}
+
+		if (command == "datasets" && words.size() == 1)
+		{
+			std::string reply = "ok";
+			std::lock_guard<std::mutex> guard(lock);
+			for (auto it = datasets.begin(); it != datasets.end(); ++it)
+				reply += " " + it->first + ":" + std::to_string(it->second->points.n) + ":" + std::to_string(it->second->points.d);
+			return reply;
+		}
+
+		if (command == "query" && words.size() >= 3 && words.size() <= 5)
+		{
+			long long K;
+			size_t used = 0;
+			try
+			{
+				K = std::stoll(words[2], &used);
+			}
+			catch (const std::exception&)
+			{
+				used = 0;
+			}
+			if (used == 0 || used != words[2].size())
+				return "error invalid k '" + words[2] + "'";
+			return query(words[1], K, words.size() > 3 ? words[3] : settings.engine,
+				words.size() > 4 ? words[4] : settings.evaluator);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		return std::string("error ") + e.what();
+	}
+
+	return "error unknown request '" + line + "'";
+}
+
+void query_server::serveStream(std::istream& in, std::ostream& out)
+{
+	std::string line;
+	while (!stopping && std::getline(in, line))
+	{
+		std::istringstream words(line);
+		std::string command;
+		if (!(words >> command))
+			continue;
+		if (command == "quit" || command == "shutdown")
+			break;
+		out << handle(line) << std::endl;
+	}
+}
+
+#ifdef KREGRET_HAVE_UNIX_SOCKETS
+
+static bool sendAll(int fd, const std::string& data)
+{
+	size_t sent = 0;
+	while (sent < data.size())
+	{
+#ifdef MSG_NOSIGNAL
+		ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+#else
+		ssize_t n = send(fd, data.data() + sent, data.size() - sent, 0);
+#endif
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return false;
+		sent += (size_t)n;
+	}
+	return true;
+}
+
+void query_server::serveConnection(int fd)
+{
+	std::string pending;
+	char buffer[4096];
+	bool open = true;
+
+	while (open)
+	{
+		ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			break;
+		pending.append(buffer, (size_t)n);
+
+		size_t eol;
+		while (open && (eol = pending.find('\n')) != std::string::npos)
+		{
+			std::string line = pending.substr(0, eol);
+			pending.erase(0, eol + 1);
+			if (!line.empty() && line.back() == '\r')
+				line.pop_back();
+
+			std::istringstream words(line);
+			std::string command;
+			if (!(words >> command))
+				continue;
+			if (command == "quit")
+				open = false;
+			else if (command == "shutdown")
+			{
+				sendAll(fd, "ok\n");
+				stopping = true;
+				::shutdown(listener, SHUT_RDWR);
+				open = false;
+			}
+			else
+				open = sendAll(fd, handle(line) + "\n");
+		}
+	}
+
+	std::lock_guard<std::mutex> guard(lock);
+	connections.erase(fd);
+	close(fd);
+	drained.notify_all();
+}
+
+bool query_server::serveSocket(const std::string& path, std::string& error)
+{
+	sockaddr_un address;
+	std::memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (path.size() >= sizeof(address.sun_path))
+	{
+		error = "Socket path is too long: " + path;
+		return false;
+	}
+	std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+	// a socket left behind by an earlier server is replaced, anything else is kept
+	struct stat info;
+	if (lstat(path.c_str(), &info) == 0)
+	{
+		if (!S_ISSOCK(info.st_mode))
+		{
+			error = path + " exists and is not a socket";
+			return false;
+		}
+		unlink(path.c_str());
+	}
+
+	listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listener < 0 || bind(listener, (sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 64) != 0)
+	{
+		error = "Cannot listen on " + path + ": " + std::strerror(errno);
+		if (listener >= 0)
+			close(listener);
+		listener = -1;
+		return false;
+	}
+
+	while (!stopping)
+	{
+		int fd = accept(listener, nullptr, nullptr);
+		if (fd < 0)
+		{
+			if (errno == EINTR && !stopping)
+				continue;
+			break;
+		}
+
+		std::lock_guard<std::mutex> guard(lock);
+		connections.insert(fd);
+		std::thread(&query_server::serveConnection, this, fd).detach();
+	}
+
+	// wake every connection still waiting for input and wait for them to end
+	std::unique_lock<std::mutex> guard(lock);
+	for (int fd : connections)
+		::shutdown(fd, SHUT_RDWR);
+	drained.wait(guard, [&]() { return connections.empty(); });
+	guard.unlock();
+
+	close(listener);
+	listener = -1;
+	unlink(path.c_str());
+	return true;
+}
+
+#else
+
+void query_server::serveConnection(int)
+{
+}
+
+bool query_server::serveSocket(const std::string&, std::string& error)
+{
+	error = "Unix domain sockets are not supported on this platform";
+	return false;
+}
+
+#endif
@@ -0,0 +1,462 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+// Regret ratio evaluation over all linear utilities
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+#include <kregret/parallel.h>
+#include <kregret/regret.h>
+#include <kregret/skyline.h>
+#include <kregret/utility_kernels.h>
+
+static const double kEpsilon = 1e-12;
+
+regret_lp::regret_lp(const double* q, size_t D, const double* s)
+	: d(D), m(0), t(D + 1, 0.0), scale(s, s + D), objective(D), nonbasic(D), unbounded(false)
+{
+	// objective row holds -q so that a negative entry marks an improving column
+	for (size_t j = 0; j < d; ++j)
+	{
+		objective[j] = q[j] * scale[j];
+		t[j] = -objective[j];
+		nonbasic[j] = j;
+	}
+}
+
+void regret_lp::addConstraint(const double* s)
+{
+	size_t i, j;
+	std::vector<double> row(d + 1, 0.0);
+
+	for (j = 0; j < d; ++j)
+		rows.push_back(s[j] * scale[j]);
+	const double* a = &rows[m * d];
+
+	// slack = 1 - a.u, with every basic u_k replaced by its row of the tableau;
+	// before the first solve all u_j are non-basic and this is just a and 1
+	for (j = 0; j < d; ++j)
+		if (nonbasic[j] < d)
+			row[j] = a[nonbasic[j]];
+	row[d] = 1.0;
+	for (i = 0; i < m; ++i)
+		if (basic[i] < d && a[basic[i]] != 0.0)
+		{
+			double f = a[basic[i]];
+			for (j = 0; j <= d; ++j)
+				row[j] -= f * at(i, j);
+		}
+
+	t.insert(t.begin() + m * (d + 1), row.begin(), row.end());
+	basic.push_back(d + m);
+	m++;
+	unbounded = false;
+}
+
+void regret_lp::pivot(size_t r, size_t c)
+{
+	size_t i, j;
+	double p = at(r, c);
+
+	for (i = 0; i <= m; ++i)
+	{
+		if (i == r || at(i, c) == 0.0)
+			continue;
+		double f = at(i, c) / p;
+		for (j = 0; j <= d; ++j)
+			if (j != c)
+				at(i, j) -= f * at(r, j);
+		at(i, c) = -f;
+	}
+	for (j = 0; j <= d; ++j)
+		if (j != c)
+			at(r, j) /= p;
+	at(r, c) = 1.0 / p;
+	std::swap(basic[r], nonbasic[c]);
+}
+
+bool regret_lp::dualSimplex()
+{
+// Pivots a dual feasible tableau (no improving column) back to primal
+// feasibility. Returns false if it gives up, e.g. on suspected cycling.
+	size_t i, j, iterations = 0;
+	const size_t limit = 50 * (d + m + 1);
+
+	while (iterations++ < limit)
+	{
+		// leaving row: most negative right-hand side
+		size_t r = m;
+		for (i = 0; i < m; ++i)
+			if (at(i, d) < -kEpsilon && (r == m || at(i, d) < at(r, d)))
+				r = i;
+		if (r == m)
+			return true;
+
+		// entering column: keeps every reduced cost non-negative
+		size_t c = d;
+		double best = std::numeric_limits<double>::infinity();
+		for (j = 0; j < d; ++j)
+			if (at(r, j) < -kEpsilon)
+			{
+				double ratio = at(m, j) / -at(r, j);
+				if (ratio < best)
+				{
+					best = ratio;
+					c = j;
+				}
+			}
+		if (c == d)
+			return false; // infeasible, which u = 0 rules out; only round-off gets here
+
+		pivot(r, c);
+	}
+	return false;
+}
+
+void regret_lp::primalSimplex()
+{
+	size_t i, j, iterations = 0;
+	const size_t blandAfter = 50 * (d + m + 1);
+
+	while (!unbounded)
+	{
+		// entering column: most negative reduced cost, or the first negative one
+		// (Bland's rule) if we have been pivoting long enough to suspect cycling
+		size_t c = d;
+		for (j = 0; j < d; ++j)
+			if (at(m, j) < -kEpsilon && (c == d || (iterations < blandAfter && at(m, j) < at(m, c))))
+				c = j;
+		if (c == d)
+			break;
+
+		// leaving row: minimum ratio test
+		size_t r = m;
+		double best = std::numeric_limits<double>::infinity();
+		for (i = 0; i < m; ++i)
+			if (at(i, c) > kEpsilon)
+			{
+				double ratio = at(i, d) / at(i, c);
+				if (ratio < best)
+				{
+					best = ratio;
+					r = i;
+				}
+			}
+		if (r == m)
+		{
+			unbounded = true;
+			break;
+		}
+
+		pivot(r, c);
+		iterations++;
+	}
+}
+
+void regret_lp::restart()
+{
+// Rebuilds the initial tableau (u = 0, every slack basic) from the stored rows
+	size_t i, j;
+
+	for (i = 0; i < m; ++i)
+	{
+		for (j = 0; j < d; ++j)
+			at(i, j) = rows[i * d + j];
+		at(i, d) = 1.0;
+		basic[i] = d + i;
+	}
+	for (j = 0; j < d; ++j)
+	{
+		at(m, j) = -objective[j];
+		nonbasic[j] = j;
+	}
+	at(m, d) = 0.0;
+	unbounded = false;
+}
+
+double regret_lp::solve()
+{
+	size_t i, j;
+	bool feasible = true, optimal = true;
+
+	for (i = 0; i < m; ++i)
+		feasible = feasible && at(i, d) >= -kEpsilon;
+	for (j = 0; j < d; ++j)
+		optimal = optimal && at(m, j) >= -kEpsilon;
+
+	// a constraint added after the last solve cut off its optimum: repair it with
+	// dual pivots, or start over if the tableau was not optimal to begin with
+	if (!feasible && !(optimal && dualSimplex()))
+		restart();
+	primalSimplex();
+
+	if (unbounded)
+		return 1.0;
+
+	double opt = at(m, d);
+	return opt > 1.0 ? 1.0 - 1.0 / opt : 0.0;
+}
+
+std::vector<double> normalization(const dataset& ds)
+{
+	std::vector<size_t> argmax(ds.d);
+	std::vector<double> scale(ds.d, 1.0);
+
+	columnArgMax(ds, argmax.data());
+	for (size_t j = 0; j < ds.d; ++j)
+	{
+		double c = ds.value(argmax[j], j);
+		if (c > 0)
+			scale[j] = 1.0 / c;
+	}
+	return scale;
+}
+
+double regretUpperBound(const dataset& ds, size_t q, const dataset& selected)
+{
+	double best = 0.0;
+
+	for (size_t s = 0; s < selected.n; ++s)
+	{
+		// largest lambda with s >= lambda * q in every dimension
+		double lambda = std::numeric_limits<double>::infinity();
+		for (size_t j = 0; j < ds.d && lambda > best; ++j)
+		{
+			double qj = ds.value(q, j), sj = selected.value(s, j);
+			if (qj > 0)
+				lambda = std::min(lambda, sj / qj);
+			else if (sj < qj)
+				lambda = 0.0;
+		}
+		best = std::max(best, lambda);
+		if (best >= 1.0)
+			return 0.0;
+	}
+
+	return 1.0 - best;
+}
+
+bool belowSelectedHull(const dataset& ds, size_t q, const dataset& selected)
+{
+	static const size_t kHullPairs = 64;
+	if (selected.n < 2 || selected.n > kHullPairs)
+		return false;
+
+	for (size_t a = 0; a < selected.n; ++a)
+		for (size_t b = a + 1; b < selected.n; ++b)
+		{
+			// the weights w of a with w*a + (1-w)*b >= q in every dimension form an interval
+			double lo = 0.0, hi = 1.0;
+			for (size_t j = 0; j < ds.d && lo <= hi; ++j)
+			{
+				double delta = selected.value(a, j) - selected.value(b, j), need = ds.value(q, j) - selected.value(b, j);
+				if (delta > 0)
+					lo = std::max(lo, need / delta);
+				else if (delta < 0)
+					hi = std::min(hi, need / delta);
+				else if (need > 0)
+					hi = -1.0;
+			}
+			if (lo <= hi)
+				return true;
+		}
+	return false;
+}
+
+static double solveRegret(const dataset& ds, size_t q, const dataset& selected, const double* scale, std::vector<double>& buffer)
+{
+	for (size_t j = 0; j < ds.d; ++j)
+		buffer[j] = ds.value(q, j);
+
+	regret_lp lp(buffer.data(), ds.d, scale);
+	for (size_t s = 0; s < selected.n; ++s)
+	{
+		for (size_t j = 0; j < ds.d; ++j)
+			buffer[j] = selected.value(s, j);
+		lp.addConstraint(buffer.data());
+	}
+	return lp.solve();
+}
+
+double regretRatio(const dataset& ds, size_t q, const dataset& selected)
+{
+	std::vector<double> scale = normalization(ds);
+	std::vector<double> buffer(ds.d);
+
+	if (regretUpperBound(ds, q, selected) <= 0.0 || belowSelectedHull(ds, q, selected))
+		return 0.0;
+	return solveRegret(ds, q, selected, scale.data(), buffer);
+}
+
+double axisMaxRegretRatio(const dataset& ds, const size_t* argmax, const std::vector<size_t>& rows)
+{
+	double worst = 0.0;
+	for (size_t j = 0; j < ds.d; ++j)
+	{
+		double overall = ds.value(argmax[j], j), best = -std::numeric_limits<double>::infinity();
+		for (size_t r : rows)
+			best = std::max(best, ds.value(r, j));
+		if (overall > 0)
+			worst = std::max(worst, (overall - best) / overall);
+	}
+	return worst;
+}
+
+double exactMaxRegretRatio(const dataset& ds, const dataset& selected, const std::vector<size_t>* candidates)
+{
+	std::vector<size_t> computed;
+	if (candidates == nullptr)
+	{
+		computed = skyline(ds);
+		candidates = &computed;
+	}
+
+	std::vector<double> scale = normalization(ds);
+	const std::vector<size_t>& cand = *candidates;
+
+	// candidates dominated by a selected point have zero regret and are dropped
+	std::vector<double> bound(cand.size());
+	parallelFor(0, cand.size(), [&](size_t lo, size_t hi, size_t) {
+		for (size_t i = lo; i < hi; ++i)
+			bound[i] = regretUpperBound(ds, cand[i], selected);
+	});
+
+	std::vector<size_t> order;
+	for (size_t i = 0; i < cand.size(); ++i)
+		if (bound[i] > 0.0)
+			order.push_back(i);
+	std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return bound[a] > bound[b]; });
+
+	// each worker takes every W-th candidate so all of them start on the most
+	// promising ones; a candidate is solved only if its bound beats the best so far
+	std::atomic<double> best(0.0);
+	size_t workers = std::max<size_t>(1, std::min(workerCount(), order.size()));
+	parallelFor(0, workers, [&](size_t lo, size_t hi, size_t) {
+		std::vector<double> buffer(ds.d);
+		for (size_t w = lo; w < hi; ++w)
+			for (size_t k = w; k < order.size(); k += workers)
+			{
+				size_t i = order[k];
+				double current = best.load();
+				if (bound[i] <= current)
+					break; // bounds are sorted, so nothing later on this stride can win
+				if (belowSelectedHull(ds, cand[i], selected))
+					continue; // ratio 0, which never beats best
+				double r = solveRegret(ds, cand[i], selected, scale.data(), buffer);
+				while (r > current && !best.compare_exchange_weak(current, r))
+					;
+			}
+	});
+
+	return best.load();
+}
+
+static void sampleBlocks(size_t D, size_t M, uint64_t seed, const double* all, size_t allCount, double* bestAll,
+	const double* chosen, size_t chosenCount, const double* best, double* blockWorst)
+{
+// Draws the M utilities block by block. With all set, bestAll receives the best
+// score of those points on each utility; with chosen set, blockWorst receives
+// the largest regret ratio of the chosen points in each block against the best
+// scores in best. Doing both in one call draws every utility once.
+	size_t blocks = (M + kUtilityBlock - 1) / kUtilityBlock;
+
+	parallelFor(0, blocks, [&](size_t lo, size_t hi, size_t) {
+		std::vector<double> w(D * kUtilityBlock), bestSet(kUtilityBlock);
+		for (size_t b = lo; b < hi; ++b)
+		{
+			size_t width = std::min(kUtilityBlock, M - b * kUtilityBlock);
+			size_t first = b * kUtilityBlock;
+
+			sampleUtilities(seed, b, D, width, w.data());
+			if (all)
+				blockMax(all, allCount, D, w.data(), width, bestAll + first);
+			if (!chosen)
+				continue;
+			blockMax(chosen, chosenCount, D, w.data(), width, bestSet.data());
+
+			double worst = 0.0;
+			for (size_t u = 0; u < width; ++u)
+				if (best[first + u] > 0)
+					worst = std::max(worst, (best[first + u] - bestSet[u]) / best[first + u]);
+			blockWorst[b] = worst;
+		}
+	});
+}
+
+static sampled_regret summarize(const std::vector<double>& blockWorst, size_t M, double confidence)
+{
+	sampled_regret result;
+	result.maxRegret = blockWorst.empty() ? 0.0 : *std::max_element(blockWorst.begin(), blockWorst.end());
+	result.samples = M;
+	result.confidence = confidence;
+	// P(all M draws miss a region of measure eps) = (1 - eps)^M <= exp(-eps M)
+	result.tail = M ? std::min(1.0, std::log(1.0 / (1.0 - confidence)) / M) : 1.0;
+	return result;
+}
+
+sampled_regret sampledMaxRegretRatio(const dataset& ds, const dataset& selected, size_t M, uint64_t seed,
+	double confidence, const std::vector<size_t>* candidates)
+{
+	std::vector<size_t> computed;
+	if (candidates == nullptr)
+	{
+		computed = skyline(ds);
+		candidates = &computed;
+	}
+
+	std::vector<double> scale = normalization(ds);
+	std::vector<double> all = packRows(ds, candidates, candidates->size(), scale.data());
+	std::vector<double> chosen = packRows(selected, nullptr, selected.n, scale.data());
+	std::vector<double> bestAll(M);
+	std::vector<double> blockWorst((M + kUtilityBlock - 1) / kUtilityBlock, 0.0);
+
+	sampleBlocks(ds.d, M, seed, all.data(), candidates->size(), bestAll.data(),
+		chosen.data(), selected.n, bestAll.data(), blockWorst.data());
+	return summarize(blockWorst, M, confidence);
+}
+
+regret_sampler::regret_sampler(const dataset& ds, size_t M, uint64_t seed_, double confidence_,
+	const std::vector<size_t>* candidates)
+	: d(ds.d), samples(M), seed(seed_), confidence(confidence_), scale(normalization(ds)), bestAll(M)
+{
+	std::vector<size_t> computed;
+	if (candidates == nullptr)
+	{
+		computed = skyline(ds);
+		candidates = &computed;
+	}
+
+	std::vector<double> all = packRows(ds, candidates, candidates->size(), scale.data());
+	sampleBlocks(d, M, seed, all.data(), candidates->size(), bestAll.data(), nullptr, 0, nullptr, nullptr);
+}
+
+sampled_regret regret_sampler::evaluate(const dataset& selected) const
+{
+	std::vector<double> chosen = packRows(selected, nullptr, selected.n, scale.data());
+	std::vector<double> blockWorst((samples + kUtilityBlock - 1) / kUtilityBlock, 0.0);
+
+	// the utilities are drawn again rather than kept, which would take M x D doubles
+	sampleBlocks(d, samples, seed, nullptr, 0, nullptr, chosen.data(), selected.n, bestAll.data(), blockWorst.data());
+	return summarize(blockWorst, samples, confidence);
+}
@@ -0,0 +1,503 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#include <kregret/shard.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#define KREGRET_HAVE_FORK 1
+#endif
+
+#include <kregret/dataset_cache.h>
+#include <kregret/skyline.h>
+
+// Requests, each a uint64_t followed by its arguments. Every reply is a
+// count or a fixed-size block, followed by the blocks it announces.
+enum shard_request : uint64_t
+{
+	kSummary = 1, // -> n, d, then if n > 0: max[d], argmax[d], the argmax rows [d][d]
+	kGrid,        // d, upper[d] -> rows inside the grid
+	kPass,        // t -> count, saturated, cube keys [count][d-1], rows [count], coordinates [count][d]
+	kSkyline,     // -> count, rows [count], coordinates [count][d]
+	kQuit
+};
+
+static bool get(FILE* in, void* data, size_t bytes)
+{
+	return bytes == 0 || fread(data, 1, bytes, in) == bytes;
+}
+
+static void put(FILE* out, const void* data, size_t bytes)
+{
+	if (bytes > 0)
+		fwrite(data, 1, bytes, out);
+}
+
+static void putRows(FILE* out, const dataset& ds, const std::vector<size_t>& rows)
+{
+// The row numbers, then the coordinates of each row
+	std::vector<uint64_t> ids(rows.begin(), rows.end());
+	std::vector<double> values(rows.size() * ds.d);
+	for(size_t r = 0; r < rows.size(); ++r)
+		for(size_t j = 0; j < ds.d; ++j)
+			values[r * ds.d + j] = ds.value(rows[r], j);
+	put(out, ids.data(), ids.size() * sizeof(uint64_t));
+	put(out, values.data(), values.size() * sizeof(double));
+}
+
+read_status loadShard(const char* path, char sep, size_t slice, size_t slices, bool useCache, dataset& out)
+{
+	dataset ds;
+	std::string cache = cachePath(path);
+	if ((isDatasetCache(path) && readDatasetCache(path, ds))
+		|| (useCache && cacheIsFresh(path, sep) && readDatasetCache(cache.c_str(), ds)))
+	{
+		// the slice is a view of its share of the mapped columns
+		size_t first = ds.n * slice / slices, last = ds.n * (slice + 1) / slices;
+		dataset view = datasetView(ds.base + first, ds.d, last - first, 1, ds.colStride);
+		view.storage = ds.storage;
+		if (slices == 1)
+			view.stats = ds.stats;
+		out = view;
+		return read_status::ok;
+	}
+
+	read_status status = readDatasetSlice(path, sep, slice, slices, ds);
+	if (status == read_status::no_data)
+	{
+		out = dataset();
+		return read_status::ok;
+	}
+	if (status == read_status::ok)
+		out = ds;
+	return status;
+}
+
+void serveShard(read_status status, const dataset& slice, FILE* in, FILE* out)
+{
+	uint64_t code = (uint64_t)status;
+	put(out, &code, sizeof(code));
+	fflush(out);
+	if (status != read_status::ok)
+		return;
+
+	size_t D = slice.d, N = slice.n;
+	std::vector<size_t> candidates;
+	std::vector<double> upper;
+	cube_scratch scratch;
+
+	while(get(in, &code, sizeof(code)) && code != kQuit)
+	{
+		if (code == kSummary)
+		{
+			uint64_t size[2] = { N, D };
+			put(out, size, sizeof(size));
+			if (N > 0)
+			{
+				std::vector<size_t> argmax(D);
+				std::vector<double> max(D);
+				columnArgMax(slice, argmax.data());
+				for(size_t j = 0; j < D; ++j)
+					max[j] = slice.value(argmax[j], j);
+				put(out, max.data(), D * sizeof(double));
+				putRows(out, slice, argmax);
+			}
+		}
+		else if (code == kGrid)
+		{
+			uint64_t width;
+			if (!get(in, &width, sizeof(width)))
+				return;
+			upper.resize(width);
+			if (!get(in, upper.data(), width * sizeof(double)))
+				return;
+			candidates.clear();
+			if (N > 0)
+				gridCandidates(slice, upper.data(), candidates, nullptr, &scratch);
+			uint64_t count = candidates.size();
+			put(out, &count, sizeof(count));
+		}
+		else if (code == kPass)
+		{
+			int64_t t;
+			if (!get(in, &t, sizeof(t)))
+				return;
+			std::vector<size_t> rows;
+			std::vector<long> keys;
+			if (!candidates.empty())
+				occupiedCells(slice, (int)t, upper.data(), candidates.data(), candidates.size(), rows, keys, &scratch);
+			// whether every distinct candidate of this shard has a cube of its own
+			uint64_t head[2] = { rows.size(), atMostDistinct(slice, candidates.data(), candidates.size(), rows.size()) };
+			std::vector<int64_t> cells(keys.begin(), keys.end());
+			put(out, head, sizeof(head));
+			put(out, cells.data(), cells.size() * sizeof(int64_t));
+			putRows(out, slice, rows);
+		}
+		else if (code == kSkyline)
+		{
+			std::vector<size_t> rows;
+			if (N > 0)
+				rows = skyline(slice);
+			uint64_t count = rows.size();
+			put(out, &count, sizeof(count));
+			putRows(out, slice, rows);
+		}
+		else
+			return;
+		fflush(out);
+	}
+}
+
+shard_coordinator::shard_coordinator() : n(0), d(0), candidates(0)
+{
+}
+
+shard_coordinator::~shard_coordinator()
+{
+	stop();
+}
+
+void shard_coordinator::send(size_t shard, const void* data, size_t bytes)
+{
+	FILE* in = workers[shard].in;
+	if ((bytes > 0 && fwrite(data, 1, bytes, in) != bytes) || fflush(in) != 0)
+		throw std::runtime_error("Shard " + std::to_string(shard) + " stopped responding");
+}
+
+void shard_coordinator::receive(size_t shard, void* data, size_t bytes)
+{
+	if (!get(workers[shard].out, data, bytes))
+		throw std::runtime_error("Shard " + std::to_string(shard) + " stopped responding");
+}
+
+bool shard_coordinator::start(const std::string& program, const std::string& path, char sep, size_t shards,
+	size_t threads, bool useCache, std::string& error)
+{
+#ifdef KREGRET_HAVE_FORK
+	stop();
+	// a worker that dies must fail the run, not kill the coordinator
+	signal(SIGPIPE, SIG_IGN);
+
+	std::string separator = sep == '\t' ? "\\t" : sep == ' ' ? "\\s" : std::string(1, sep);
+	std::string jobs = std::to_string(std::max<size_t>(threads, 1));
+	for(size_t s = 0; s < shards; ++s)
+	{
+		int requests[2], replies[2];
+		if (pipe(requests) != 0)
+		{
+			error = "Cannot create a pipe for shard " + std::to_string(s);
+			return false;
+		}
+		if (pipe(replies) != 0)
+		{
+			close(requests[0]);
+			close(requests[1]);
+			error = "Cannot create a pipe for shard " + std::to_string(s);
+			return false;
+		}
+
+		std::string slice = std::to_string(s) + "/" + std::to_string(shards);
+		pid_t pid = fork();
+		if (pid == 0)
+		{
+			dup2(requests[0], STDIN_FILENO);
+			dup2(replies[1], STDOUT_FILENO);
+			close(requests[0]);
+			close(requests[1]);
+			close(replies[0]);
+			close(replies[1]);
+			for(const worker& w : workers)
+			{
+				fclose(w.in);
+				fclose(w.out);
+			}
+			std::vector<const char*> args = { program.c_str(), "--shard-worker", slice.c_str(), "-f", path.c_str(),
+				"-s", separator.c_str(), "-j", jobs.c_str() };
+			if (!useCache)
+				args.push_back("--no-cache");
+			args.push_back(nullptr);
+			execvp(program.c_str(), const_cast<char* const*>(args.data()));
+			_exit(127);
+		}
+
+		close(requests[0]);
+		close(replies[1]);
+		if (pid < 0)
+		{
+			close(requests[1]);
+			close(replies[0]);
+			error = "Cannot start shard " + std::to_string(s);
+			return false;
+		}
+		workers.push_back({ (int)pid, fdopen(requests[1], "wb"), fdopen(replies[0], "rb"), 0, 0 });
+	}
+
+	try
+	{
+		// the workers load their slices concurrently
+		for(size_t s = 0; s < shards; ++s)
+		{
+			uint64_t status;
+			receive(s, &status, sizeof(status));
+			if (status == (uint64_t)read_status::cannot_open)
+				throw std::runtime_error("Cannot open file " + path);
+			if (status != (uint64_t)read_status::ok)
+				throw std::runtime_error("Shard " + std::to_string(s) + " cannot load its slice");
+		}
+
+		uint64_t code = kSummary;
+		for(size_t s = 0; s < shards; ++s)
+			send(s, &code, sizeof(code));
+
+		// the first shard holding a maximum has its lowest row, as columnArgMax() picks it
+		for(size_t s = 0; s < shards; ++s)
+		{
+			uint64_t size[2];
+			receive(s, size, sizeof(size));
+			workers[s].first = n;
+			workers[s].n = size[0];
+			n += size[0];
+			if (size[0] == 0)
+				continue;
+			bool first = d == 0;
+			if (first)
+			{
+				d = size[1];
+				c.assign(d, 0);
+				upper.assign(d, 0.0);
+			}
+			else if (size[1] != d)
+				throw std::runtime_error("Shards disagree on the number of dimensions");
+
+			std::vector<double> max(d), values(d * d);
+			std::vector<uint64_t> rows(d);
+			receive(s, max.data(), d * sizeof(double));
+			receive(s, rows.data(), d * sizeof(uint64_t));
+			receive(s, values.data(), d * d * sizeof(double));
+			for(size_t j = 0; j < d; ++j)
+				if (first || max[j] > upper[j])
+				{
+					c[j] = workers[s].first + rows[j];
+					upper[j] = max[j];
+					known[c[j]].assign(values.begin() + j * d, values.begin() + (j + 1) * d);
+				}
+		}
+	}
+	catch (const std::runtime_error& e)
+	{
+		error = e.what();
+		stop();
+		return false;
+	}
+	return true;
+#else
+	error = "Sharded runs need a POSIX system";
+	return false;
+#endif
+}
+
+void shard_coordinator::stop()
+{
+#ifdef KREGRET_HAVE_FORK
+	uint64_t code = kQuit;
+	for(const worker& w : workers)
+	{
+		fwrite(&code, sizeof(code), 1, w.in);
+		fclose(w.in);
+	}
+	for(const worker& w : workers)
+	{
+		fclose(w.out);
+		waitpid(w.pid, nullptr, 0);
+	}
+#endif
+	workers.clear();
+	n = d = candidates = 0;
+	c.clear();
+	upper.clear();
+	known.clear();
+	passes.clear();
+}
+
+const cube_pass& shard_coordinator::pass(int t, int K)
+{
+// The pass over the union of the shards' cube representatives: the best one
+// per cube, a larger value in L and then a lower row winning as in cube()
+	auto it = passes.find(t);
+	if (it != passes.end())
+		return it->second;
+
+	size_t L = d - 1;
+	std::vector<double> pool;       // c, then the representatives, row-major
+	std::vector<size_t> poolRows;   // their input rows
+	for(size_t j = 0; j < d; ++j)
+	{
+		pool.insert(pool.end(), known[c[j]].begin(), known[c[j]].end());
+		poolRows.push_back(c[j]);
+	}
+
+	// std::map walks the cubes most significant strip first, in counter order
+	std::map<std::vector<long>, size_t> cells;
+	bool saturated = false;
+	if (L < (size_t)K)
+	{
+		saturated = true;
+		uint64_t request[2] = { kPass, (uint64_t)(int64_t)t };
+		for(size_t s = 0; s < workers.size(); ++s)
+			send(s, request, sizeof(request));
+		for(size_t s = 0; s < workers.size(); ++s)
+		{
+			uint64_t head[2];
+			receive(s, head, sizeof(head));
+			uint64_t count = head[0];
+			saturated = saturated && head[1];
+			std::vector<int64_t> keys(count * L);
+			std::vector<uint64_t> rows(count);
+			std::vector<double> values(count * d);
+			receive(s, keys.data(), keys.size() * sizeof(int64_t));
+			receive(s, rows.data(), rows.size() * sizeof(uint64_t));
+			receive(s, values.data(), values.size() * sizeof(double));
+
+			for(size_t r = 0; r < count; ++r)
+			{
+				const double* p = values.data() + r * d;
+				auto cell = cells.emplace(std::vector<long>(keys.begin() + r * L, keys.begin() + (r + 1) * L), poolRows.size());
+				if (cell.second)
+				{
+					pool.insert(pool.end(), p, p + d);
+					poolRows.push_back(workers[s].first + rows[r]);
+				}
+				else
+				{
+					// two shards sharing a cube only matters if their points differ
+					const double* q = pool.data() + cell.first->second * d;
+					for(size_t j = 0; j < d && saturated; ++j)
+						saturated = !(p[j] < q[j] || p[j] > q[j]);
+					if (p[L] > q[L])
+					{
+						// earlier shards hold lower rows, so only a larger value replaces
+						std::copy(p, p + d, pool.begin() + cell.first->second * d);
+						poolRows[cell.first->second] = workers[s].first + rows[r];
+					}
+				}
+			}
+		}
+	}
+
+	std::vector<size_t> order, boundary(d);
+	for(const auto& cell : cells)
+		order.push_back(cell.second);
+	for(size_t j = 0; j < d; ++j)
+		boundary[j] = j;
+
+	cube_pass r;
+	std::vector<size_t> answer(std::max<size_t>(K, d) + 1);
+	r.distinct = cubeAnswer(datasetView(pool.data(), d, poolRows.size(), d, 1), K, L, boundary.data(), order,
+		answer.data());
+	// once every distinct candidate sits in its own cube a finer grid cannot find more points
+	r.saturated = cells.size() == candidates || saturated;
+	for(size_t& i : answer)
+	{
+		known[poolRows[i]].assign(pool.begin() + i * d, pool.begin() + (i + 1) * d);
+		i = poolRows[i];
+	}
+	r.answer = std::move(answer);
+	return passes.emplace(t, std::move(r)).first->second;
+}
+
+bool shard_coordinator::cube(int K, const cube_options& options, std::vector<size_t>& rows, std::string& error)
+{
+	try
+	{
+		// the grid of the global maxima, kept by the shards for every pass
+		std::vector<uint64_t> request = { kGrid, d };
+		request.resize(2 + d);
+		std::copy(upper.begin(), upper.end(), reinterpret_cast<double*>(request.data() + 2));
+		for(size_t s = 0; s < workers.size(); ++s)
+			send(s, request.data(), request.size() * sizeof(uint64_t));
+		candidates = 0;
+		for(size_t s = 0; s < workers.size(); ++s)
+		{
+			uint64_t count;
+			receive(s, &count, sizeof(count));
+			candidates += count;
+		}
+
+		passes.clear();
+		int limit = std::max(K, 1);
+		int t = searchGrid(d, n, K, options, [&](int t) -> const cube_pass& { return pass(t, limit); });
+		const cube_pass& chosen = pass(t, limit);
+		rows.assign(chosen.answer.begin(), chosen.answer.begin() + K);
+	}
+	catch (const std::runtime_error& e)
+	{
+		error = e.what();
+		return false;
+	}
+	return true;
+}
+
+dataset shard_coordinator::points(const std::vector<size_t>& rows) const
+{
+	dataset out = allocateDataset(d, rows.size());
+	for(size_t r = 0; r < rows.size(); ++r)
+		std::copy(known.at(rows[r]).begin(), known.at(rows[r]).end(), out.row(r));
+	return out;
+}
+
+bool shard_coordinator::skylines(dataset& points, std::vector<size_t>& rows, std::string& error)
+{
+	try
+	{
+		uint64_t code = kSkyline;
+		for(size_t s = 0; s < workers.size(); ++s)
+			send(s, &code, sizeof(code));
+
+		// the slices are in input order and each skyline is sorted
+		std::vector<double> values;
+		rows.clear();
+		for(size_t s = 0; s < workers.size(); ++s)
+		{
+			uint64_t count;
+			receive(s, &count, sizeof(count));
+			std::vector<uint64_t> ids(count);
+			receive(s, ids.data(), count * sizeof(uint64_t));
+			size_t offset = values.size();
+			values.resize(offset + count * d);
+			receive(s, values.data() + offset, count * d * sizeof(double));
+			for(uint64_t i : ids)
+				rows.push_back(workers[s].first + i);
+		}
+
+		points = allocateDataset(d, rows.size());
+		std::copy(values.begin(), values.end(), points.base);
+	}
+	catch (const std::runtime_error& e)
+	{
+		error = e.what();
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,93 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+// Size lists given on the command line (-k and the benchmark sweeps)
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include <kregret/size_list.h>
+
+bool parseSizes(const std::string& arg, std::vector<size_t>& sizes, std::string& error)
+{
+	sizes.clear();
+	size_t start = 0;
+	while (start <= arg.size())
+	{
+		size_t comma = arg.find(',', start);
+		std::string item = arg.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+		start = comma == std::string::npos ? arg.size() + 1 : comma + 1;
+
+		long long bounds[3] = { 0, 0, 1 };
+		size_t parts = 0, pos = 0;
+		try
+		{
+			for (;;)
+			{
+				size_t colon = item.find(':', pos);
+				std::string field = item.substr(pos, colon == std::string::npos ? std::string::npos : colon - pos);
+				size_t used = 0;
+				if (parts == 3)
+				{
+					error = "too many ':' in '" + item + "'";
+					return false;
+				}
+				bounds[parts++] = std::stoll(field, &used);
+				if (used != field.size())
+				{
+					error = "invalid size '" + item + "'";
+					return false;
+				}
+				if (colon == std::string::npos)
+					break;
+				pos = colon + 1;
+			}
+		}
+		catch (const std::exception&)
+		{
+			error = "invalid size '" + item + "'";
+			return false;
+		}
+		if (parts == 1)
+			bounds[1] = bounds[0];
+
+		if (bounds[0] <= 0 || bounds[1] <= 0)
+		{
+			error = "sizes must be positive";
+			return false;
+		}
+		if (bounds[1] < bounds[0] || bounds[2] <= 0)
+		{
+			error = "range '" + item + "' is empty";
+			return false;
+		}
+		if (bounds[1] > std::numeric_limits<int>::max())
+		{
+			error = "size '" + item + "' is too large";
+			return false;
+		}
+		for (long long k = bounds[0]; k <= bounds[1]; k += bounds[2])
+			sizes.push_back((size_t)k);
+	}
+
+	std::sort(sizes.begin(), sizes.end());
+	sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+	return true;
+}
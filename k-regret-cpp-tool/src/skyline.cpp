@@ -0,0 +1,184 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+// Skyline computation using sort-filter-skyline (SFS) on partitions
+#include <algorithm>
+#include <numeric>
+
+#include <kregret/kernels.h>
+#include <kregret/parallel.h>
+#include <kregret/skyline.h>
+#include <kregret/stats.h>
+
+// Sort key for SFS: a point can only be dominated by points sorted before it.
+// Equal sums are broken lexicographically (a dominator is lexicographically
+// larger) and identical points by row index.
+struct sfs_order
+{
+	const dataset* ds;
+	const double* sum;
+
+	bool operator()(size_t a, size_t b) const
+	{
+		if (sum[a] != sum[b])
+			return sum[a] > sum[b];
+		for (size_t j = 0; j < ds->d; ++j)
+		{
+			double va = ds->value(a, j), vb = ds->value(b, j);
+			if (va != vb)
+				return va > vb;
+		}
+		return a < b;
+	}
+};
+
+// Survivors tested together before checking for a dominator
+static const size_t kWindowBlock = 32;
+
+// Survivor coordinates packed dimension-major, so that one candidate is
+// compared against a block of survivors with contiguous loads
+struct sfs_window
+{
+	size_t d;
+	size_t count;
+	size_t capacity;
+	std::vector<double> values; // values[j * capacity + w]
+
+	explicit sfs_window(size_t D) : d(D), count(0), capacity(0) {}
+
+	void push(const double* p)
+	{
+		if (count == capacity)
+		{
+			size_t grown = std::max<size_t>(2 * capacity, kWindowBlock);
+			std::vector<double> next(d * grown);
+			for (size_t j = 0; j < d; ++j)
+				std::copy(values.begin() + j * capacity, values.begin() + j * capacity + count, next.begin() + j * grown);
+			values.swap(next);
+			capacity = grown;
+		}
+		for (size_t j = 0; j < d; ++j)
+			values[j * capacity + count] = p[j];
+		count++;
+	}
+};
+
+KREGRET_TARGET_CLONES
+static bool windowDominates(const double* window, size_t stride, size_t count, const double* p, size_t D)
+{
+// True if one of the first count window points weakly dominates p, the same
+// test as dominates(): w[j] >= p[j] for every j
+	return dispatchDimension(D, [&](auto fd) KREGRET_INLINE_LAMBDA {
+		constexpr size_t FD = decltype(fd)::value;
+		for (size_t w0 = 0; w0 < count; w0 += kWindowBlock)
+		{
+			size_t w1 = std::min(count, w0 + kWindowBlock);
+			bool any = false;
+			for (size_t w = w0; w < w1; ++w)
+				any |= dominatesKernel<FD>(window + w, stride, p, D);
+			if (any)
+				return true;
+		}
+		return false;
+	});
+}
+
+static void sfsFilter(const dataset& ds, std::vector<size_t>& rows, const sfs_order& order)
+{
+// Sorts rows in SFS order and keeps the ones not dominated by an earlier survivor
+	std::sort(rows.begin(), rows.end(), order);
+
+	sfs_window window(ds.d);
+	std::vector<double> p(ds.d);
+	size_t kept = 0;
+	for (size_t r = 0; r < rows.size(); ++r)
+	{
+		for (size_t j = 0; j < ds.d; ++j)
+			p[j] = ds.value(rows[r], j);
+		if (!windowDominates(window.values.data(), window.capacity, window.count, p.data(), ds.d))
+		{
+			window.push(p.data());
+			rows[kept++] = rows[r];
+		}
+	}
+	rows.resize(kept);
+}
+
+std::vector<size_t> skyline(const dataset& ds)
+{
+	stat_timer timer(stat_phase::skyline);
+	size_t N = ds.n;
+	std::vector<double> sum(N);
+	sfs_order order{&ds, sum.data()};
+
+	parallelFor(0, N, [&](size_t lo, size_t hi, size_t) {
+		for (size_t i = lo; i < hi; ++i)
+		{
+			double s = 0.0;
+			for (size_t j = 0; j < ds.d; ++j)
+				s += ds.value(i, j);
+			sum[i] = s;
+		}
+	});
+
+	// local skylines of contiguous partitions, one per worker
+	size_t parts = std::max<size_t>(1, std::min(workerCount(), N));
+	std::vector<std::vector<size_t>> local(parts);
+	parallelFor(0, parts, 1, [&](size_t lo, size_t hi, size_t) {
+		for (size_t p = lo; p < hi; ++p)
+		{
+			local[p].resize(N * (p + 1) / parts - N * p / parts);
+			std::iota(local[p].begin(), local[p].end(), N * p / parts);
+			sfsFilter(ds, local[p], order);
+		}
+	});
+
+	// every global skyline point survives its own partition, and anything that
+	// dominates a local survivor is dominated by (or is) another local survivor,
+	// so checking each survivor against the earlier ones in SFS order suffices
+	std::vector<size_t> merged;
+	for (size_t w = 0; w < local.size(); ++w)
+		merged.insert(merged.end(), local[w].begin(), local[w].end());
+	std::sort(merged.begin(), merged.end(), order);
+
+	size_t M = merged.size();
+	std::vector<double> packed(ds.d * M);
+	for (size_t r = 0; r < M; ++r)
+		for (size_t j = 0; j < ds.d; ++j)
+			packed[j * M + r] = ds.value(merged[r], j);
+
+	std::vector<char> keep(M, 1);
+	parallelFor(0, M, [&](size_t lo, size_t hi, size_t) {
+		std::vector<double> p(ds.d);
+		for (size_t r = lo; r < hi; ++r)
+		{
+			for (size_t j = 0; j < ds.d; ++j)
+				p[j] = packed[j * M + r];
+			keep[r] = !windowDominates(packed.data(), M, r, p.data(), ds.d);
+		}
+	});
+
+	std::vector<size_t> result;
+	for (size_t r = 0; r < merged.size(); ++r)
+		if (keep[r])
+			result.push_back(merged[r]);
+	std::sort(result.begin(), result.end());
+	return result;
+}
@@ -0,0 +1,175 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+// Embeddable solver: status codes instead of exits, caller-owned input
+#include <exception>
+#include <new>
+
+#include <kregret/data_reader.h>
+#include <kregret/dataset_cache.h>
+#include <kregret/greedy.h>
+#include <kregret/hitting_set.h>
+#include <kregret/planar.h>
+#include <kregret/regret.h>
+#include <kregret/solver.h>
+#include <kregret/sphere.h>
+
+const char* solverStatusMessage(solver_status status)
+{
+	switch (status)
+	{
+	case solver_status::ok:                 return "ok";
+	case solver_status::cannot_open:        return "cannot open file";
+	case solver_status::no_data:            return "no valid data";
+	case solver_status::too_few_dimensions: return "number of dimensions must be at least 2";
+	case solver_status::invalid_k:          return "k must be between 1 and the number of points";
+	case solver_status::invalid_view:       return "invalid point buffer";
+	case solver_status::out_of_memory:      return "out of memory";
+	default:                                return "internal error";
+	}
+}
+
+solver_status loadDataset(const char* path, char sep, dataset& out, bool useCache, bool verifyCache)
+{
+	try
+	{
+		// prefer a binary cache, exactly as the command line does
+		if (isDatasetCache(path) && readDatasetCache(path, out))
+			return solver_status::ok;
+		if (useCache && cacheIsFresh(path, sep, verifyCache) && readDatasetCache(cachePath(path).c_str(), out))
+			return solver_status::ok;
+
+		switch (readDataset(path, sep, out))
+		{
+		case read_status::cannot_open:
+			return solver_status::cannot_open;
+		case read_status::no_data:
+			return solver_status::no_data;
+		default:
+			return solver_status::ok;
+		}
+	}
+	catch (const std::bad_alloc&)
+	{
+		return solver_status::out_of_memory;
+	}
+	catch (const std::exception&)
+	{
+		return solver_status::internal_error;
+	}
+}
+
+kregret_solver::kregret_solver(const solver_settings& settings)
+	: config(settings)
+{
+}
+
+solver_status kregret_solver::solve(const double* values, size_t D, size_t N, size_t rowStride, size_t colStride, int K,
+	kregret_result& result)
+{
+	if (values == nullptr || colStride == 0 || (rowStride == 0 && N > 1))
+		return solver_status::invalid_view;
+	// the engines only read the points
+	return solve(datasetView(const_cast<double*>(values), D, N, rowStride, colStride), K, result);
+}
+
+solver_status kregret_solver::solve(const dataset& points, int K, kregret_result& result)
+{
+	if (points.base == nullptr)
+		return solver_status::invalid_view;
+	if (points.n == 0)
+		return solver_status::no_data;
+	if (points.d <= 1)
+		return solver_status::too_few_dimensions;
+	if (K <= 0 || (size_t)K > points.n)
+		return solver_status::invalid_k;
+
+	try
+	{
+		return run(points, K, result);
+	}
+	catch (const std::bad_alloc&)
+	{
+		return solver_status::out_of_memory;
+	}
+	catch (const std::exception&)
+	{
+		return solver_status::internal_error;
+	}
+}
+
+solver_status kregret_solver::run(const dataset& points, int K, kregret_result& result)
+{
+	double exact = -1.0; // exact ratio if the engine knows it
+	indices.resize(K);
+	switch (config.engine)
+	{
+	case solver_engine::greedy:
+		exact = greedy(points, K, indices.data()).max_regret;
+		break;
+	case solver_engine::sphere:
+		sphere(points, K, indices.data());
+		break;
+	case solver_engine::hitting_set:
+		hittingSet(points, K, indices.data(), config.hsDirections, config.seed);
+		break;
+	default:
+		// two columns have an exact engine, as on the command line
+		if (planarApplies(points))
+			exact = planar(points, K, indices.data()).max_regret;
+		else
+			cube(points, K, indices.data(), config.options, nullptr, &scratch);
+		break;
+	}
+
+	rows.assign(indices.begin(), indices.end());
+	result.result_indices.assign(rows.begin(), rows.end());
+	result.result_points.clear();
+	if (points.rowMajor())
+	{
+		// rows of the caller's buffer are already contiguous points
+		for (size_t i = 0; i < rows.size(); ++i)
+			result.addPoint(points.at(rows[i]));
+		result.storage = points.storage;
+	}
+	else
+	{
+		dataset selected = selectRows(points, rows);
+		for (size_t i = 0; i < rows.size(); ++i)
+			result.addPoint(selected.at(i));
+		result.storage = selected.storage;
+	}
+
+	switch (config.evaluator)
+	{
+	case solver_evaluator::exact:
+		result.max_regret = exact >= 0.0 ? exact : exactMaxRegretRatio(points, selectRows(points, rows));
+		break;
+	case solver_evaluator::sampled:
+		result.max_regret = sampledMaxRegretRatio(points, selectRows(points, rows), config.samples, config.seed).maxRegret;
+		break;
+	default:
+		argmax.resize(points.d);
+		columnArgMax(points, argmax.data());
+		result.max_regret = axisMaxRegretRatio(points, argmax.data(), rows);
+		break;
+	}
+	return solver_status::ok;
+}
@@ -0,0 +1,126 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+// Algorithm covering sampled utility directions (Sphere)
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include <kregret/greedy.h>
+#include <kregret/kdtree.h>
+#include <kregret/parallel.h>
+#include <kregret/regret.h>
+#include <kregret/skyline.h>
+#include <kregret/sphere.h>
+
+// Directions are queried in batches of this size; a batch is drawn from its
+// own seeded stream so the draw does not depend on threading
+static const size_t kDirectionBatch = 1024;
+// Stops drawing after this many directions per requested point, or earlier
+// once a whole batch finds no new point; greedy fills the slots left
+static const size_t kDirectionsPerPoint = 64;
+// R as a multiple of sqrt(D), the largest norm of a scaled point
+static const double kRadius = 4.0;
+static const uint64_t kSeed = 0x5EED5EED5EED5EEDULL;
+
+kregret_result sphere(const dataset& ds, int K, int *maxIndex)
+{
+	size_t D = ds.d;
+	size_t i, j;
+	std::vector<size_t> rows = skyline(ds);
+	std::vector<double> scale = normalization(ds);
+	std::vector<size_t> chosen;
+	std::unordered_set<size_t> seen;
+	kregret_result result;
+
+	// the maximal points in each direction come first
+	std::vector<size_t> c(D);
+	columnArgMax(ds, c.data());
+	for (j = 0; j < D && chosen.size() < (size_t)K; ++j)
+		if (seen.insert(c[j]).second)
+			chosen.push_back(c[j]);
+
+	std::vector<double> packed(rows.size() * D);
+	for (i = 0; i < rows.size(); ++i)
+		for (j = 0; j < D; ++j)
+			packed[i * D + j] = ds.value(rows[i], j) * scale[j];
+	kd_tree tree(packed.data(), rows.size(), D);
+
+	double radius = kRadius * std::sqrt((double)D);
+	size_t budget = kDirectionsPerPoint * (size_t)K;
+	std::vector<double> targets(kDirectionBatch * D);
+	std::vector<size_t> found(kDirectionBatch);
+
+	bool progress = true;
+	for (size_t b = 0; progress && chosen.size() < (size_t)K && b * kDirectionBatch < budget; ++b)
+	{
+		std::mt19937_64 rng(kSeed ^ (0x9E3779B97F4A7C15ULL * (b + 1)));
+		std::normal_distribution<double> normal(0.0, 1.0);
+		for (i = 0; i < kDirectionBatch; ++i)
+		{
+			double* u = &targets[i * D];
+			double norm = 0.0;
+			for (j = 0; j < D; ++j)
+			{
+				u[j] = std::fabs(normal(rng));
+				norm += u[j] * u[j];
+			}
+			norm = std::sqrt(norm);
+			for (j = 0; j < D; ++j)
+				u[j] *= radius / norm;
+		}
+
+		parallelFor(0, kDirectionBatch, [&](size_t lo, size_t hi, size_t) {
+			for (size_t k = lo; k < hi; ++k)
+				found[k] = rows[tree.nearest(&targets[k * D])];
+		});
+
+		// keep the new points in direction order
+		size_t before = chosen.size();
+		for (i = 0; i < kDirectionBatch && chosen.size() < (size_t)K; ++i)
+			if (seen.insert(found[i]).second)
+				chosen.push_back(found[i]);
+		progress = chosen.size() > before;
+	}
+
+	// the directions no longer tell the points apart: spend the slots left on
+	// the points with the largest regret ratio, as Sphere does
+	if (chosen.size() < (size_t)K)
+		greedyExtend(ds, rows, chosen, (size_t)K);
+
+	// fill in any remaining positions with the first point found
+	for (j = 0; j < (size_t)K; ++j)
+		maxIndex[j] = (int)chosen[j < chosen.size() ? j : 0];
+
+	result.result_indices.assign(maxIndex, maxIndex + K);
+	dataset points = selectRows(ds, result.result_indices);
+	for (j = 0; j < (size_t)K; ++j)
+		result.addPoint(points.at(j));
+	result.storage = points.storage;
+	return result;
+}
+
+kregret_result sphere(size_t D, size_t N, int K, struct point *p, int *maxIndex)
+{
+	return sphere(datasetFromPoints(p, D, N), K, maxIndex);
+}
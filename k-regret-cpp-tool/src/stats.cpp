@@ -0,0 +1,123 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+// Phase timers and algorithm counters reported by --stats
+#include <atomic>
+#include <iomanip>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include <kregret/stats.h>
+
+std::atomic<bool> statsFlag(false);
+static std::atomic<uint64_t> phaseTime[(size_t)stat_phase::count];
+static std::atomic<uint64_t> phaseRuns[(size_t)stat_phase::count];
+static std::atomic<uint64_t> counters[(size_t)stat_counter::count];
+
+static const char* const phaseNames[] = {
+	"parse", "cache_read", "convert", "skyline", "select", "cube_pass", "resolve", "evaluate"
+};
+static const char* const counterNames[] = {
+	"t_values", "cells_walked", "cells_occupied", "points_scanned", "dedup_hits"
+};
+
+static_assert(sizeof(phaseNames) / sizeof(*phaseNames) == (size_t)stat_phase::count, "a name per phase");
+static_assert(sizeof(counterNames) / sizeof(*counterNames) == (size_t)stat_counter::count, "a name per counter");
+
+void enableStats()
+{
+	statsFlag.store(true, std::memory_order_relaxed);
+}
+
+void addStatTime(stat_phase phase, uint64_t nanoseconds)
+{
+	phaseTime[(size_t)phase].fetch_add(nanoseconds, std::memory_order_relaxed);
+	phaseRuns[(size_t)phase].fetch_add(1, std::memory_order_relaxed);
+}
+
+void addStat(stat_counter counter, uint64_t amount)
+{
+	counters[(size_t)counter].fetch_add(amount, std::memory_order_relaxed);
+}
+
+uint64_t peakMemory()
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS info;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &info, sizeof(info)))
+		return (uint64_t)info.PeakWorkingSetSize;
+	return 0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#if defined(__APPLE__)
+	return (uint64_t)usage.ru_maxrss;        // bytes
+#else
+	return (uint64_t)usage.ru_maxrss * 1024; // kilobytes
+#endif
+#endif
+}
+
+void printStats(std::ostream& out, bool json)
+{
+	std::ios::fmtflags flags = out.flags();
+	std::streamsize precision = out.precision();
+	out << std::fixed << std::setprecision(3);
+
+	if (json)
+	{
+		out << "{\"phases\": {";
+		bool first = true;
+		for (size_t p = 0; p < (size_t)stat_phase::count; ++p)
+		{
+			if (phaseRuns[p] == 0)
+				continue;
+			out << (first ? "" : ", ") << "\"" << phaseNames[p] << "\": {\"ms\": " << phaseTime[p] / 1e6
+				<< ", \"calls\": " << phaseRuns[p] << "}";
+			first = false;
+		}
+		out << "}, \"counters\": {";
+		for (size_t c = 0; c < (size_t)stat_counter::count; ++c)
+			out << (c ? ", " : "") << "\"" << counterNames[c] << "\": " << counters[c];
+		out << "}, \"peak_memory_bytes\": " << peakMemory() << "}" << std::endl;
+	}
+	else
+	{
+		out << "\n=== Statistics ===" << std::endl;
+		for (size_t p = 0; p < (size_t)stat_phase::count; ++p)
+			if (phaseRuns[p] > 0)
+				out << std::left << std::setw(18) << phaseNames[p] << std::right << std::setw(12) << phaseTime[p] / 1e6
+					<< " ms" << (phaseRuns[p] > 1 ? "  (" + std::to_string(phaseRuns[p]) + " calls)" : "") << std::endl;
+		for (size_t c = 0; c < (size_t)stat_counter::count; ++c)
+			out << std::left << std::setw(18) << counterNames[c] << std::right << std::setw(12) << counters[c] << std::endl;
+		out << std::left << std::setw(18) << "peak_memory" << std::right << std::setw(12) << std::setprecision(1)
+			<< peakMemory() / 1048576.0 << " MiB" << std::endl;
+	}
+
+	out.flags(flags);
+	out.precision(precision);
+}
@@ -0,0 +1,176 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+#include <kregret/thread_pool.h>
+
+#include <atomic>
+#include <exception>
+
+// Worker number of the current thread while it runs a chunk, or none
+static const size_t kNoWorker = (size_t)-1;
+static thread_local size_t currentWorker = kNoWorker;
+
+struct thread_pool::job
+{
+	const std::function<void(size_t, size_t, size_t)>* body;
+	std::atomic<size_t> remaining;
+	std::mutex lock;
+	std::condition_variable done;
+	bool finished;
+	std::atomic<bool> failed;   // the chunks left are skipped once one throws
+	std::exception_ptr error;   // the first exception, under lock
+};
+
+thread_pool::thread_pool(size_t n)
+	: workers(n > 0 ? n : 1), generation(0), stopping(false)
+{
+	for (size_t w = 0; w < workers; ++w)
+		queues.emplace_back(new task_queue);
+	for (size_t w = 1; w < workers; ++w)
+		threads.emplace_back(&thread_pool::loop, this, w);
+}
+
+thread_pool::~thread_pool()
+{
+	{
+		std::lock_guard<std::mutex> guard(wake);
+		stopping = true;
+	}
+	posted.notify_all();
+	for (size_t i = 0; i < threads.size(); ++i)
+		threads[i].join();
+}
+
+bool thread_pool::next(size_t w, task& t)
+{
+// Front of the worker's own deque, else the back of another worker's
+	for (size_t k = 0; k < workers; ++k)
+	{
+		task_queue& q = *queues[(w + k) % workers];
+		std::lock_guard<std::mutex> guard(q.lock);
+		if (q.tasks.empty())
+			continue;
+		if (k == 0)
+		{
+			t = std::move(q.tasks.front());
+			q.tasks.pop_front();
+		}
+		else
+		{
+			t = std::move(q.tasks.back());
+			q.tasks.pop_back();
+		}
+		return true;
+	}
+	return false;
+}
+
+void thread_pool::execute(size_t w, task& t)
+{
+	size_t previous = currentWorker;
+	currentWorker = w;
+	if (!t.owner->failed)
+		try
+		{
+			(*t.owner->body)(t.lo, t.hi, w);
+		}
+		catch (...)
+		{
+			// an exception must not leave a pool thread; run() rethrows it
+			std::lock_guard<std::mutex> guard(t.owner->lock);
+			if (!t.owner->error)
+				t.owner->error = std::current_exception();
+			t.owner->failed = true;
+		}
+	currentWorker = previous;
+
+	if (t.owner->remaining.fetch_sub(1) == 1)
+	{
+		std::lock_guard<std::mutex> guard(t.owner->lock);
+		t.owner->finished = true;
+		t.owner->done.notify_all();
+	}
+	t.owner.reset();
+}
+
+void thread_pool::loop(size_t w)
+{
+	size_t seen = 0;
+	task t;
+
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> guard(wake);
+			posted.wait(guard, [&] { return stopping || generation != seen; });
+			if (stopping)
+				return;
+			seen = generation;
+		}
+		while (next(w, t))
+			execute(w, t);
+	}
+}
+
+void thread_pool::run(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t, size_t)>& body)
+{
+	if (end <= begin)
+		return;
+	if (grain == 0)
+		grain = 1;
+
+	size_t chunks = (end - begin + grain - 1) / grain;
+	if (currentWorker != kNoWorker || workers == 1 || chunks == 1)
+	{
+		// nested, serial or too small to be worth waking anyone
+		body(begin, end, currentWorker != kNoWorker ? currentWorker : 0);
+		return;
+	}
+
+	std::lock_guard<std::mutex> one(serial);
+	std::shared_ptr<job> j = std::make_shared<job>();
+	j->body = &body;
+	j->remaining = chunks;
+	j->finished = false;
+	j->failed = false;
+
+	// worker w starts with the w-th contiguous run of chunks
+	for (size_t c = 0; c < chunks; ++c)
+	{
+		size_t lo = begin + c * grain;
+		task_queue& q = *queues[c * workers / chunks];
+		std::lock_guard<std::mutex> guard(q.lock);
+		q.tasks.push_back(task{lo, std::min(end, lo + grain), j});
+	}
+	{
+		std::lock_guard<std::mutex> guard(wake);
+		generation++;
+	}
+	posted.notify_all();
+
+	task t;
+	while (next(0, t))
+		execute(0, t);
+
+	std::unique_lock<std::mutex> guard(j->lock);
+	j->done.wait(guard, [&] { return j->finished; });
+	if (j->error)
+		std::rethrow_exception(j->error);
+}
@@ -0,0 +1,138 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+// Blocked kernels scoring points against sampled utilities
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include <kregret/kernels.h>
+#include <kregret/utility_kernels.h>
+
+std::vector<double> packRows(const dataset& ds, const std::vector<size_t>* rows, size_t count, const double* scale)
+{
+	std::vector<double> packed(count * ds.d);
+	for (size_t i = 0; i < count; ++i)
+	{
+		size_t r = rows ? (*rows)[i] : i;
+		for (size_t j = 0; j < ds.d; ++j)
+			packed[i * ds.d + j] = ds.value(r, j) * scale[j];
+	}
+	return packed;
+}
+
+void sampleUtilities(uint64_t seed, size_t b, size_t D, size_t width, double* w)
+{
+	// each block has its own stream so the draw does not depend on threading
+	std::mt19937_64 rng(seed ^ (0x9E3779B97F4A7C15ULL * (b + 1)));
+	std::normal_distribution<double> normal(0.0, 1.0);
+
+	for (size_t u = 0; u < width; ++u)
+	{
+		double norm = 0.0;
+		for (size_t j = 0; j < D; ++j)
+		{
+			double x = std::fabs(normal(rng));
+			w[j * width + u] = x;
+			norm += x * x;
+		}
+		norm = std::sqrt(norm);
+		for (size_t j = 0; j < D; ++j)
+			w[j * width + u] /= norm;
+	}
+}
+
+static inline void scoreRow(const double* p, size_t D, const double* w, size_t width, double* acc)
+{
+// acc[u] = p . w_u
+	const double* wj = w;
+	for (size_t u = 0; u < width; ++u)
+		acc[u] = p[0] * wj[u];
+	for (size_t j = 1; j < D; ++j)
+	{
+		wj += width;
+		double pj = p[j];
+		for (size_t u = 0; u < width; ++u)
+			acc[u] += pj * wj[u];
+	}
+}
+
+// p . w_u for a dimension fixed at compile time, summed in the same order as
+// scoreRow so both give bit-identical scores
+template <size_t FD>
+static KREGRET_ALWAYS_INLINE double scoreFixed(const double* p, const double* w, size_t width, size_t u)
+{
+	double s = p[0] * w[u];
+	for (size_t j = 1; j < FD; ++j)
+		s += p[j] * w[j * width + u];
+	return s;
+}
+
+KREGRET_TARGET_CLONES
+void blockMax(const double* points, size_t count, size_t D, const double* w, size_t width, double* best)
+{
+	for (size_t u = 0; u < width; ++u)
+		best[u] = -std::numeric_limits<double>::infinity();
+
+	dispatchDimension(D, [&](auto fd) KREGRET_INLINE_LAMBDA {
+		constexpr size_t FD = decltype(fd)::value;
+		if (FD == 0)
+		{
+			std::vector<double> acc(width);
+			for (size_t i = 0; i < count; ++i)
+			{
+				scoreRow(points + i * D, D, w, width, acc.data());
+				for (size_t u = 0; u < width; ++u)
+					best[u] = acc[u] > best[u] ? acc[u] : best[u];
+			}
+			return;
+		}
+		// with the dimension known, a whole score fits in registers
+		for (size_t i = 0; i < count; ++i)
+		{
+			const double* p = points + i * D;
+			for (size_t u = 0; u < width; ++u)
+			{
+				double s = scoreFixed<FD>(p, w, width, u);
+				best[u] = s > best[u] ? s : best[u];
+			}
+		}
+	});
+}
+
+KREGRET_TARGET_CLONES
+void blockScores(const double* points, size_t count, size_t D, const double* w, size_t width, double* scores)
+{
+	dispatchDimension(D, [&](auto fd) KREGRET_INLINE_LAMBDA {
+		constexpr size_t FD = decltype(fd)::value;
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (FD == 0)
+			{
+				scoreRow(points + i * D, D, w, width, scores + i * width);
+				continue;
+			}
+			const double* p = points + i * D;
+			for (size_t u = 0; u < width; ++u)
+				scores[i * width + u] = scoreFixed<FD>(p, w, width, u);
+		}
+	});
+}
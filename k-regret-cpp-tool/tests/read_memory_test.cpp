@@ -0,0 +1,95 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+
+// Peak memory of readDataset(): parsing N rows of D values must cost about
+// the N*D doubles of the result, not the text of the file or a second copy of
+// the values. The input is written a line at a time so that generating it
+// does not raise the peak itself.
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include <kregret/data_reader.h>
+#include <kregret/dataset.h>
+#include <kregret/parallel.h>
+#include <kregret/stats.h>
+
+static const size_t kRows = 1 << 20;
+static const size_t kDims = 8;
+static const size_t kWorkers = 4;
+// allowance for the text each worker holds before handing it back (8 MiB
+// per worker), the thread pool and the runtime
+static const uint64_t kSlack = 40ull << 20;
+
+static bool writeInput(const std::string& path)
+{
+	FILE* out = fopen(path.c_str(), "w");
+	if (out == nullptr)
+		return false;
+	uint64_t state = 1;
+	for(size_t i = 0; i < kRows; ++i)
+		for(size_t j = 0; j < kDims; ++j)
+		{
+			state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+			fprintf(out, "%.6f%c", (double)(state >> 11) / 9007199254740992.0 * 1000, j + 1 < kDims ? ',' : '\n');
+		}
+	return fclose(out) == 0;
+}
+
+int main()
+{
+	std::string path = (std::filesystem::temp_directory_path() / "kregret_read_memory_test.csv").string();
+	if (!writeInput(path))
+	{
+		std::cerr << "Cannot write " << path << std::endl;
+		return 1;
+	}
+	uint64_t text = std::filesystem::file_size(path);
+
+	setWorkerCount(kWorkers);
+	uint64_t before = peakMemory();
+	dataset ds;
+	read_status status = readDataset(path.c_str(), ',', ds);
+	uint64_t after = peakMemory();
+	std::filesystem::remove(path);
+
+	if (before == 0)
+	{
+		std::cout << "Peak memory is not known on this system; skipped" << std::endl;
+		return 0;
+	}
+	if (status != read_status::ok || ds.n != kRows || ds.d != kDims)
+	{
+		std::cerr << "Read " << ds.n << " x " << ds.d << ", expected " << kRows << " x " << kDims << std::endl;
+		return 1;
+	}
+
+	uint64_t values = kRows * kDims * sizeof(double), limit = before + values + kSlack;
+	std::cout << "text " << text / 1048576.0 << " MiB, values " << values / 1048576.0 << " MiB, peak "
+		<< before / 1048576.0 << " -> " << after / 1048576.0 << " MiB, limit " << limit / 1048576.0 << " MiB" << std::endl;
+	if (after > limit)
+	{
+		std::cerr << "Peak memory exceeds N*D*8 plus " << kSlack / 1048576 << " MiB" << std::endl;
+		return 1;
+	}
+	return 0;
+}
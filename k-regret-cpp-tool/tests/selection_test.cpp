@@ -0,0 +1,99 @@
+//==========================================================================================
+//Copyright 2025 ©, 2025 Matthew Rinker
+//
+//This file is a part of the k-regret-cpp project.
+//
+//The k-regret-cpp project is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    The k-regret-cpp project is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//along with this program. If not, see <http://www.gnu.org/licenses/>.
+//==========================================================================================
+
+// Engines through kregret_solver on inputs that once went wrong: data that
+// needs no point at all, and sets whose sampled regret is already 0, or whose
+// sampled directions stop finding new points, while slots are left. An
+// engine must return K rows of the input, and fewer than K distinct ones only
+// when their exact regret ratio is 0.
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <kregret/dataset.h>
+#include <kregret/regret.h>
+#include <kregret/solver.h>
+
+static int failures = 0;
+
+static void expect(bool condition, const std::string& what)
+{
+	if (!condition)
+	{
+		std::cerr << "FAILED: " << what << std::endl;
+		failures++;
+	}
+}
+
+static void checkSelection(const char* name, const dataset& ds, solver_engine engine, int K)
+{
+	solver_settings settings;
+	settings.engine = engine;
+	kregret_solver solver(settings);
+	kregret_result result;
+	std::string what = std::string(name) + " k=" + std::to_string(K);
+
+	solver_status status = solver.solve(ds, K, result);
+	expect(status == solver_status::ok, what + ": " + solverStatusMessage(status));
+	if (status != solver_status::ok)
+		return;
+	expect(result.result_indices.size() == (size_t)K, what + ": returned " +
+		std::to_string(result.result_indices.size()) + " rows");
+
+	std::vector<size_t> rows;
+	for (int i : result.result_indices)
+	{
+		expect(i >= 0 && (size_t)i < ds.n, what + ": row " + std::to_string(i) + " out of range");
+		if (i < 0 || (size_t)i >= ds.n)
+			return;
+		rows.push_back((size_t)i);
+	}
+
+	size_t distinct = std::set<size_t>(rows.begin(), rows.end()).size();
+	if (distinct < (size_t)K)
+	{
+		double regret = exactMaxRegretRatio(ds, selectRows(ds, rows));
+		expect(regret <= 0.0, what + ": " + std::to_string(distinct) + " distinct rows with exact regret " +
+			std::to_string(regret));
+	}
+}
+
+int main()
+{
+	// every direction is served by any row, so the cover picks nothing
+	dataset zero = datasetFromRows(std::vector<std::vector<double>>(3, std::vector<double>(3, 0.0)), 3, 3);
+	checkSelection("hitting set, all zero", zero, solver_engine::hitting_set, 2);
+
+	// a few points serve every sampled direction exactly
+	dataset stock;
+	solver_status status = loadDataset(KREGRET_TEST_DATA_DIR "/stock.csv", ',', stock, false);
+	expect(status == solver_status::ok, std::string("stock.csv: ") + solverStatusMessage(status));
+	if (status == solver_status::ok)
+		for (int K : { 10, 40, 200 })
+		{
+			checkSelection("hitting set, stock.csv", stock, solver_engine::hitting_set, K);
+			// a batch of directions finding no new point stops the sampling, not the selection
+			checkSelection("sphere, stock.csv", stock, solver_engine::sphere, K);
+		}
+
+	if (failures == 0)
+		std::cout << "All selections passed" << std::endl;
+	return failures == 0 ? 0 : 1;
+}